@@ -130,7 +130,7 @@ PYBIND11_MODULE(rhoban, m)
     .def("setScheduler", &Helpers::setScheduler)
     .def("lockScheduler", &Helpers::lockScheduler)
     .def("unlockScheduler", &Helpers::unlockScheduler)
-    .def("getAngle", &Helpers::getAngle)
+    .def("getAngle", (float (Helpers::*)(const std::string&)) & Helpers::getAngle)
     .def("setSchedulerClock", &Helpers::setSchedulerClock)
     .def("setFakeIMU", &Helpers::setFakeIMU)
     .def("setFakePosition", &Helpers::setFakePosition)
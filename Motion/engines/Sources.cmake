@@ -1,3 +1,4 @@
 set (SOURCES
+    kick_table.cpp
     walk_engine.cpp
 )
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "engines/kick_table.h"
+
+#include <rhoban_utils/util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace rhoban
+{
+KickTable::KickTable() : t0(0), dt(1)
+{
+}
+
+KickTable::KickTable(const std::vector<std::string>& dofs, double t0, double dt) : dofs(dofs), t0(t0), dt(dt)
+{
+  if (dt <= 0)
+  {
+    throw std::logic_error(DEBUG_INFO + " period should be strictly positive");
+  }
+}
+
+const std::vector<std::string>& KickTable::getDofs() const
+{
+  return dofs;
+}
+
+void KickTable::addSample(const std::vector<double>& angles)
+{
+  if (angles.size() != dofs.size())
+  {
+    throw std::logic_error(DEBUG_INFO + " invalid number of angles");
+  }
+  values.insert(values.end(), angles.begin(), angles.end());
+}
+
+size_t KickTable::getNbSamples() const
+{
+  return dofs.size() == 0 ? 0 : values.size() / dofs.size();
+}
+
+double KickTable::getDuration() const
+{
+  size_t nb_samples = getNbSamples();
+  return nb_samples == 0 ? 0 : t0 + (nb_samples - 1) * dt;
+}
+
+void KickTable::getAngles(double t, std::vector<double>& angles) const
+{
+  size_t nb_dofs = dofs.size();
+  size_t nb_samples = getNbSamples();
+  angles.resize(nb_dofs);
+  if (nb_samples == 0)
+  {
+    std::fill(angles.begin(), angles.end(), 0);
+    return;
+  }
+  double pos = (t - t0) / dt;
+  size_t idx = 0;
+  double ratio = 0;
+  if (pos >= nb_samples - 1)
+  {
+    idx = nb_samples - 1;
+  }
+  else if (pos > 0)
+  {
+    idx = (size_t)std::floor(pos);
+    ratio = pos - idx;
+  }
+  const double* row = values.data() + idx * nb_dofs;
+  if (ratio == 0)
+  {
+    std::copy(row, row + nb_dofs, angles.begin());
+    return;
+  }
+  const double* next_row = row + nb_dofs;
+  for (size_t dof = 0; dof < nb_dofs; dof++)
+  {
+    angles[dof] = (1 - ratio) * row[dof] + ratio * next_row[dof];
+  }
+}
+
+KickTable KickTable::mirror() const
+{
+  // For each dof, column of the symmetric dof and sign applied
+  size_t nb_dofs = dofs.size();
+  std::vector<size_t> sources(nb_dofs);
+  std::vector<double> signs(nb_dofs, 1);
+  for (size_t dof = 0; dof < nb_dofs; dof++)
+  {
+    std::string name = dofs[dof];
+    if (rhoban_utils::strContains(name, "left"))
+    {
+      rhoban_utils::replaceAll(name, "left", "right");
+    }
+    else
+    {
+      rhoban_utils::replaceAll(name, "right", "left");
+    }
+    if (rhoban_utils::strContains(name, "roll") || rhoban_utils::strContains(name, "yaw"))
+    {
+      signs[dof] = -1;
+    }
+    auto it = std::find(dofs.begin(), dofs.end(), name);
+    if (it == dofs.end())
+    {
+      throw std::logic_error(DEBUG_INFO + " no symmetric dof for '" + dofs[dof] + "'");
+    }
+    sources[dof] = it - dofs.begin();
+  }
+
+  KickTable result(dofs, t0, dt);
+  result.values.resize(values.size());
+  for (size_t row = 0; row < getNbSamples(); row++)
+  {
+    for (size_t dof = 0; dof < nb_dofs; dof++)
+    {
+      result.values[row * nb_dofs + dof] = signs[dof] * values[row * nb_dofs + sources[dof]];
+    }
+  }
+  return result;
+}
+
+}  // namespace rhoban
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace rhoban
+{
+/// Trajectories of a set of dofs sampled at a constant period
+///
+/// Samples are stored in a dense row-major table (one row per sample), angles
+/// at any time are obtained by linear interpolation between the two closest
+/// rows. Before the first sample and after the last one, the angles of the
+/// first and last samples are used.
+class KickTable
+{
+public:
+  KickTable();
+
+  /// @param dofs Names of the dofs, in the order of the angles of the samples
+  /// @param t0 Time of the first sample [s]
+  /// @param dt Period between two samples [s]
+  KickTable(const std::vector<std::string>& dofs, double t0, double dt);
+
+  const std::vector<std::string>& getDofs() const;
+
+  /// Append a sample, angles are given in the order of the dofs
+  void addSample(const std::vector<double>& angles);
+
+  size_t getNbSamples() const;
+
+  /// Time of the last sample [s]
+  double getDuration() const;
+
+  /// Fill 'angles' with the angles of all the dofs at time 't', in the order
+  /// of the dofs
+  void getAngles(double t, std::vector<double>& angles) const;
+
+  /// Return the table for the other foot: trajectories of the left and right
+  /// dofs are swapped and roll and yaw angles are negated. Throws if a dof has
+  /// no symmetric dof
+  KickTable mirror() const;
+
+private:
+  std::vector<std::string> dofs;
+  double t0;
+  double dt;
+
+  /// Angles of the sample i are stored in [i * dofs.size(), (i+1) * dofs.size()[
+  std::vector<double> values;
+};
+}  // namespace rhoban
@@ -61,6 +61,14 @@ Kick::Kick(Head* _head, Walk* _walk, Arms* _arms) : head(_head), walk(_walk), ar
 
   // Load available kicks
   kmc.loadFile();
+
+  for (const std::string& dof : dofs)
+  {
+    dofHandles.push_back(getDofHandle(dof));
+  }
+
+  // Compiling all the kicks at startup, kickGen can be used to reload them
+  cmdKickGen();
 }
 
 void Kick::set(bool _left, const std::string& _kickName, bool _pause, bool _cancellable)
@@ -113,10 +121,9 @@ void Kick::cancel()
   forceCancel = true;
 }
 
-void Kick::loadKick(std::string filename)
+Kick::CompiledKick Kick::loadKick(const std::string& filename)
 {
   bind->pull();
-  splines.clear();
   double t = 0;
   double xMax = 0;
 
@@ -147,9 +154,12 @@ void Kick::loadKick(std::string filename)
   }
   logger.log("Maximum time: %f", xMax);
 
-  // Generating
+  // Generating, the first sample is at T=dt
+  CompiledKick kick;
+  kick.table = rhoban::KickTable(dofs, dt, dt);
+  kick.tKick = -1;
+  std::vector<double> sample(dofs.size());
   double T = 0;
-  tKick = -1;
   while (t < xMax)
   {
     T += dt;
@@ -158,13 +168,14 @@ void Kick::loadKick(std::string filename)
       remap = 1;
     t += dt * remap;
 
-    if (kickSplines.count("kick") && kickSplines["kick"].get(t) > 0.5 && tKick < 0)
+    if (kickSplines.count("kick") && kickSplines["kick"].get(t) > 0.5 && kick.tKick < 0)
     {
-      tKick = T;
+      kick.tKick = T;
     }
 
-    for (auto dof : dofs)
+    for (size_t dofIndex = 0; dofIndex < dofs.size(); dofIndex++)
     {
+      const std::string& dof = dofs[dofIndex];
       auto name = dof;
       double sign = 1;
       replaceAll(name, "right", "shoot");
@@ -186,17 +197,20 @@ void Kick::loadKick(std::string filename)
         val = sign * kickSplines[name].get(t);
       }
 
-      splines[dof].addPoint(T, val);
+      sample[dofIndex] = val;
     }
+    kick.table.addSample(sample);
   }
 
-  tMax = T;
-  if (tKick < 0)
+  kick.tMax = T;
+  if (kick.tKick < 0)
   {
     logger.warning("No tKick for %s, using t=0", filename.c_str());
-    tKick = 0;
+    kick.tKick = 0;
   }
-  logger.log("tMax = %f, tKick=%f", tMax, tKick);
+  logger.log("tMax = %f, tKick=%f", kick.tMax, kick.tKick);
+
+  return kick;
 }
 
 std::string Kick::getPath(const std::string kickName, bool left)
@@ -211,45 +225,50 @@ std::string Kick::getPath(const std::string kickName, bool left)
   }
 }
 
+std::shared_ptr<const Kick::CompiledKick> Kick::compileKick(const std::string& name, bool leftFoot)
+{
+  if (!leftFoot)
+  {
+    return std::make_shared<const CompiledKick>(loadKick(getPath(name)));
+  }
+
+  // Using specific splines for the left foot if available
+  CompiledKick kick = file_exists(getPath(name, true)) ? loadKick(getPath(name, true)) : loadKick(getPath(name));
+
+  // Mirroring the play for the left foot, except for the throw-in
+  if (name != "throwin")
+  {
+    kick.table = kick.table.mirror();
+  }
+  return std::make_shared<const CompiledKick>(std::move(kick));
+}
+
 std::string Kick::cmdKickGen()
 {
-  preloadedSplines.clear();
-  maxTimes.clear();
+  std::map<std::string, std::shared_ptr<const CompiledKick>> newRightKicks, newLeftKicks;
 
   try
   {
     for (const std::string& kickName : kmc.getKickNames())
     {
       logger.log("Generating spline for '%s' kick", kickName.c_str());
-      // Loading the kick
-      loadKick(getPath(kickName));
-      preloadedSplines[kickName] = splines;
-      maxTimes[kickName] = tMax;
-      kickTimes[kickName] = tKick;
-
-      // Writing it to output file
-      logger.log("Generated spline, tMax=%f", tMax);
-
-      // Trying to compile specific splines for left foot
-      if (file_exists(getPath(kickName, true)))
-      {
-        // Loading the kick
-        loadKick(getPath(kickName, true));
-        std::string tmp = kickName + "_left";
-        preloadedSplines[tmp] = splines;
-        maxTimes[tmp] = tMax;
-        kickTimes[tmp] = tKick;
-        // Writing it to output file
-        logger.log("Generated spline, specific for left, tMax=%f", tMax);
-      }
+      newRightKicks[kickName] = compileKick(kickName, false);
+      newLeftKicks[kickName] = compileKick(kickName, true);
+      logger.log("Generated spline, tMax=%f (right), %f (left)", newRightKicks[kickName]->tMax,
+                 newLeftKicks[kickName]->tMax);
     }
   }
-  catch (const rhoban_utils::JsonParsingError& exc)
+  catch (const std::exception& exc)
   {
     logger.error("%s", exc.what());
     return exc.what();
   }
 
+  // Kicks being played keep their own reference on their tables
+  std::lock_guard<std::mutex> lock(kicksMutex);
+  rightKicks.swap(newRightKicks);
+  leftKicks.swap(newLeftKicks);
+
   return "Generated";
 }
 
@@ -275,51 +294,34 @@ void Kick::onStart()
     arms->setArms(Arms::ArmsState::ArmsDisabled);
   }
 
+  std::shared_ptr<const CompiledKick> kick;
   if (live)
   {
-    if (left && file_exists(getPath(kickName, true)))
-    {
-      loadKick(getPath(kickName, true));
-    }
-    else
-    {
-      loadKick(getPath(kickName));
-    }
+    kick = compileKick(kickName, left);
   }
   else
   {
-    try
-    {
-      if (left)
-      {
-        // Trying to load specific splines
-        auto tmp = kickName + "_left";
-        if (preloadedSplines.count(tmp))
-        {
-          splines = preloadedSplines.at(tmp);
-          tMax = maxTimes.at(tmp);
-          tKick = kickTimes.at(tmp);
-        }
-        else
-        {
-          splines = preloadedSplines.at(kickName);
-          tMax = maxTimes.at(kickName);
-          tKick = kickTimes.at(kickName);
-        }
-      }
-      else
-      {
-        splines = preloadedSplines.at(kickName);
-        tMax = maxTimes.at(kickName);
-        tKick = kickTimes.at(kickName);
-      }
-    }
-    catch (const std::out_of_range& exc)
+    std::lock_guard<std::mutex> lock(kicksMutex);
+    const auto& kicks = left ? leftKicks : rightKicks;
+    auto it = kicks.find(kickName);
+    if (it != kicks.end())
     {
-      logger.error("Kick::onStart: unknown kick '%s'", kickName.c_str());
+      kick = it->second;
     }
   }
 
+  if (kick == nullptr)
+  {
+    // Nothing can be played, the move is stopped immediately
+    logger.error("Kick::onStart: unknown kick '%s'", kickName.c_str());
+    over = true;
+    stop();
+    return;
+  }
+  currentKick = kick;
+  tMax = kick->tMax;
+  tKick = kick->tKick;
+
   logger.log("Starting kick '%s', tMax=%f", kickName.c_str(), tMax);
   t = 0;
   over = false;
@@ -465,30 +467,11 @@ void Kick::stepSpline(float elapsed)
         t = tMax;
     }
 
-    for (auto dof : dofs)
+    // Tables of the left foot are already mirrored
+    currentKick->table.getAngles(t, angles);
+    for (size_t idx = 0; idx < dofHandles.size(); idx++)
     {
-      auto name = dof;
-      double sign = 1;
-
-      // Mirroring the play for the left foot
-      if (left && kickName != "throwin")
-      {
-        if (strContains(name, "left"))
-        {
-          replaceAll(name, "left", "right");
-        }
-        else
-        {
-          replaceAll(name, "right", "left");
-        }
-
-        if (strContains(name, "roll") || strContains(name, "yaw"))
-        {
-          sign = -1;
-        }
-      }
-
-      setAngle(dof, splines[name].get(t) * sign);
+      setAngle(dofHandles[idx], angles[idx]);
     }
   }
 
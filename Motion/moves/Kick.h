@@ -2,9 +2,13 @@
 
 #include <rhoban_utils/spline/function.h>
 #include "Move.h"
+#include "engines/kick_table.h"
 
 #include "kick_model/kick_model_collection.h"
 
+#include <memory>
+#include <mutex>
+
 class Walk;
 class Head;
 class Arms;
@@ -26,7 +30,21 @@ public:
   bool live;
   std::string cmdKickGen();
 
-  void loadKick(std::string filename);
+  /**
+   * A kick ready to be played for a given foot
+   */
+  struct CompiledKick
+  {
+    // Angles of the dofs [deg]
+    rhoban::KickTable table;
+    double tMax, tKick;
+  };
+
+  /**
+   * Sample the splines of the given file with a period dt, the kick is
+   * compiled for the right foot
+   */
+  CompiledKick loadKick(const std::string& filename);
 
   void set(bool left, const std::string& kickName, bool pause = false, bool cancellable = false);
   void unpause();
@@ -35,8 +53,6 @@ public:
   static std::string getPath(const std::string kickName, bool left = false);
 
 protected:
-  typedef std::map<std::string, rhoban_utils::Function> Splines;
-
   bool useManualT;
   double manualT;
   bool applied;
@@ -72,13 +88,19 @@ protected:
   // Name of the kick which should be used
   std::string kickName;
 
-  // Splines
-  std::map<std::string, rhoban_utils::Function> splines;
+  // Kick being played
+  std::shared_ptr<const CompiledKick> currentKick;
+
+  // Precompiled kicks for the right and for the left foot
+  std::map<std::string, std::shared_ptr<const CompiledKick>> rightKicks, leftKicks;
+  std::mutex kicksMutex;
+
+  // Compile the kick for the given foot from its files
+  std::shared_ptr<const CompiledKick> compileKick(const std::string& name, bool leftFoot);
 
-  // Preloaded splines
-  std::map<std::string, Splines> preloadedSplines;
-  std::map<std::string, double> maxTimes;
-  std::map<std::string, double> kickTimes;
+  // Handles of the dofs and angles of the current tick
+  std::vector<DofHandle> dofHandles;
+  std::vector<double> angles;
 
   // The collection of available kicks
   csa_mdp::KickModelCollection kmc;
@@ -91,18 +91,17 @@ void MCKickController::execute()
     // Updating the kicking strategy if the move is running
     if (isRunning())
     {
-      // Importing data from move scheduler, copying data for local computation
-      getScheduler()->mutex.lock();
-      LocalisationService* localisation = getServices()->localisation;
-      RefereeService* referee = getServices()->referee;
-      auto decision = getServices()->decision;
+      // Importing data from the snapshots published by the move scheduler
+      auto localisation = getServices()->localisation->getSnapshot();
+      auto decision = getServices()->decision->getSnapshot();
       bool nextKickIsThrowIn = decision->nextKickIsThrowIn;
-      auto ball = localisation->getBallPosField();
-      auto robotPos = localisation->getFieldPos();
-      auto teamMatesField = localisation->getTeamMatesField();
-      auto opponentsField = localisation->getOpponentsField();
+      auto ball = localisation->ballPosField;
+      auto robotPos = localisation->fieldPos;
+      const auto& teamMatesField = localisation->teamMatesField;
+      const auto& opponentsField = localisation->opponentsField;
       auto opponentsRadius = localisation->opponentsRadius;
-      bool canScore = referee->canScore;
+      getScheduler()->mutex.lock();
+      bool canScore = getServices()->referee->canScore;
       getScheduler()->mutex.unlock();
 
       if (nextKickIsThrowIn)
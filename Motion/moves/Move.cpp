@@ -72,6 +72,7 @@ void Move::start(double fade)
     }
 
     _isRunning = true;
+    notifyScheduler();
     onStart();
   }
 }
@@ -90,6 +91,7 @@ void Move::stop(double fade)
       onStop();
       _isRunning = false;
       _smoothing = 0.0;
+      notifyScheduler();
     }
   }
 }
@@ -150,6 +152,7 @@ bool Move::tick(double elapsed)
     if (!isRunning())
     {
       onStop();
+      notifyScheduler();
     }
   }
 
@@ -168,6 +171,14 @@ void Move::initializeBinding()
   bind->bindFunc(this->getName(), "Starts the move " + this->getName(), &Move::cmdStart, *this);
 }
 
+void Move::notifyScheduler()
+{
+  if (getScheduler() != nullptr)
+  {
+    getScheduler()->notifyMoveState();
+  }
+}
+
 std::string Move::cmdStart()
 {
   start(0.3);
@@ -181,3 +192,8 @@ void Move::setAngle(const std::string& servo, float angle)
 {
   this->Helpers::setAngle(servo, angle * _smoothing);
 }
+
+void Move::setAngle(DofHandle dof, float angle)
+{
+  this->Helpers::setAngle(dof, angle * _smoothing);
+}
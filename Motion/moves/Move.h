@@ -69,6 +69,7 @@ public:
    * Setting angle (forwards to the helpers applying smoothing)
    */
   void setAngle(const std::string& servo, float angle) override;
+  void setAngle(DofHandle dof, float angle) override;
 
   /**
    * Initialize the RhIO binding
@@ -106,6 +107,11 @@ private:
    */
   std::string _error;
 
+  /**
+   * Notify the scheduler that the running state changed
+   */
+  void notifyScheduler();
+
   /**
    * Start RhIO command
    */
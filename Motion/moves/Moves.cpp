@@ -59,8 +59,6 @@ Moves::Moves(MoveScheduler* scheduler) : _scheduler(scheduler)
   Kick* kick = new Kick(head, walk, arms);
   walk->setKick(kick);
   add(kick);
-  // Forcing generation of kick motions at kick creation
-  kick->cmdKickGen();
 
   Placer* placer = new Placer(walk);
 
@@ -43,6 +43,7 @@ private:
   /**
    * Moves container and map
    * (For direct access and well defined iteration order).
+   * Running moves are ticked in the order they are added.
    */
   std::vector<std::pair<std::string, Move*>> _container;
   std::map<std::string, Move*> _map;
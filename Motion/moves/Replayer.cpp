@@ -27,6 +27,10 @@ Replayer::Replayer()
       ->persisted(true);
   bind->bindNew("enable", enable)->defaultValue(true)->persisted(true);
   bind->bindNew("over", over, RhIO::Bind::PushOnly)->comment("Is the move over?")->defaultValue(true);
+  for (const std::string& name : _dofNames)
+  {
+    dofs.push_back(getDofHandle(name));
+  }
 }
 
 Replayer::~Replayer()
@@ -61,9 +65,10 @@ void Replayer::step(float elapsed)
   {
     time += elapsed * speed / 5.0;
     //	std::cout << "time = " << time << std::endl;
-    for (const auto& name : _dofNames)
+    for (size_t idx = 0; idx < dofs.size(); idx++)
     {
-      setAngle(name, splines[name].get(time));
+      const std::string& name = _dofNames[idx];
+      setAngle(dofs[idx], splines[name].get(time));
       if (name == "left_elbow")
       {
         //  std::cout << "left_elbow angle = " << splines[name].get(time) << std::endl;
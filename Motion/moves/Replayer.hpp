@@ -23,4 +23,7 @@ protected:
   float speed;
   std::map<std::string, rhoban_utils::Function> splines;
   bool enable;
+
+  /// Handles of the servos, in the order of the names of the dofs
+  std::vector<DofHandle> dofs;
 };
@@ -44,6 +44,17 @@ StandUp::StandUp(Arms* arms) : arms(arms)
   bind->bindNew("layDown", layDown, RhIO::Bind::PullOnly)->defaultValue(false);
 
   bind->bindNew("reloadSpline", reloadSpline, RhIO::Bind::PushAndPull)->defaultValue(false);
+
+  leftShoulderRoll = getDofHandle("left_shoulder_roll");
+  rightShoulderRoll = getDofHandle("right_shoulder_roll");
+  for (std::string spline : { "shoulder_pitch", "elbow" })
+  {
+    symmetricDofs.push_back({ spline, getDofHandle("left_" + spline), getDofHandle("right_" + spline) });
+  }
+  for (std::string spline : { "hip_pitch", "knee", "ankle_pitch" })
+  {
+    symmetricLegs.push_back({ spline, getLegIndex("left_" + spline), getLegIndex("right_" + spline) });
+  }
 }
 
 StandUp::~StandUp()
@@ -161,18 +172,24 @@ void StandUp::step(float elapsed)
         playTime = layDownEnd - playTime;
       }
 
-      setAngle("left_shoulder_roll", armsRoll);
-      setAngle("right_shoulder_roll", -armsRoll);
-      setAngle("left_shoulder_pitch", splines["shoulder_pitch"].get(playTime));
-      setAngle("right_shoulder_pitch", splines["shoulder_pitch"].get(playTime));
-      setAngle("left_elbow", splines["elbow"].get(playTime));
-      setAngle("right_elbow", splines["elbow"].get(playTime));
-      setAngle("left_hip_pitch", splines["hip_pitch"].get(playTime));
-      setAngle("right_hip_pitch", splines["hip_pitch"].get(playTime));
-      setAngle("left_knee", splines["knee"].get(playTime));
-      setAngle("right_knee", splines["knee"].get(playTime));
-      setAngle("left_ankle_pitch", splines["ankle_pitch"].get(playTime));
-      setAngle("right_ankle_pitch", splines["ankle_pitch"].get(playTime));
+      setAngle(leftShoulderRoll, armsRoll);
+      setAngle(rightShoulderRoll, -armsRoll);
+      for (const SymmetricDofs& dofs : symmetricDofs)
+      {
+        float angle = splines[dofs.spline].get(playTime);
+        setAngle(dofs.left, angle);
+        setAngle(dofs.right, angle);
+      }
+      // Hip yaw and roll and ankle roll are kept at zero
+      LegAngles legAngles;
+      legAngles.fill(0);
+      for (const SymmetricLegs& legs : symmetricLegs)
+      {
+        float angle = splines[legs.spline].get(playTime);
+        legAngles[legs.left] = angle;
+        legAngles[legs.right] = angle;
+      }
+      setLegAngles(legAngles);
       if (layDown)
       {
         over = playTime < 0;
@@ -41,4 +41,26 @@ protected:
 
   std::string currentSpline;
   bool reloadSpline;
+
+  /**
+   * Arm servos receiving the same spline value on both sides
+   */
+  struct SymmetricDofs
+  {
+    std::string spline;
+    DofHandle left, right;
+  };
+  std::vector<SymmetricDofs> symmetricDofs;
+
+  /**
+   * Leg servos receiving the same spline value on both sides, by position in
+   * LegAngles
+   */
+  struct SymmetricLegs
+  {
+    std::string spline;
+    size_t left, right;
+  };
+  std::vector<SymmetricLegs> symmetricLegs;
+  DofHandle leftShoulderRoll, rightShoulderRoll;
 };
@@ -322,9 +322,24 @@ void Walk::step(float elapsed)
 
   // Assigning to robot
   std::map<std::string, double> angles = engine.computeAngles(modelService->model, timeSinceLastStep);
-  for (auto& entry : angles)
+  if (angles.size() > 0)
   {
-    setAngle(entry.first, rad2deg(entry.second));
+    if (angles.size() != angleLegIndices.size())
+    {
+      // The engine always provides the same dofs, indices are only computed once
+      angleLegIndices.clear();
+      for (auto& entry : angles)
+      {
+        angleLegIndices.push_back(getLegIndex(entry.first));
+      }
+    }
+    LegAngles legAngles;
+    size_t dofIndex = 0;
+    for (auto& entry : angles)
+    {
+      legAngles[angleLegIndices[dofIndex++]] = rad2deg(entry.second);
+    }
+    setLegAngles(legAngles);
   }
 
   bind->push();
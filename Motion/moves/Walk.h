@@ -140,4 +140,7 @@ protected:
   // Minimum stopping time for walk
   double minimumStopTime;
   double stopTime;
+
+  // Position in LegAngles of the angles computed by the engine, in their order
+  std::vector<size_t> angleLegIndices;
 };
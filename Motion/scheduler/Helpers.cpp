@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <stdexcept>
 #include <rhoban_utils/timing/time_stamp.h>
 #include <rhoban_utils/logging/logger.h>
@@ -227,6 +228,113 @@ std::vector<std::string> Helpers::getServoNames()
   return servos;
 }
 
+Helpers::DofHandle Helpers::getDofHandle(const std::string& servo)
+{
+  for (size_t idx = 0; idx < _dofs.size(); idx++)
+  {
+    if (_dofs[idx].name == servo)
+    {
+      return idx;
+    }
+  }
+  _dofs.push_back({ servo, nullptr });
+  return _dofs.size() - 1;
+}
+
+const std::string& Helpers::getDofName(DofHandle dof) const
+{
+  return _dofs.at(dof).name;
+}
+
+RhAL::DXL& Helpers::getDofDevice(DofHandle dof)
+{
+  DofEntry& entry = _dofs[dof];
+  if (entry.device == nullptr)
+  {
+    entry.device = &(_scheduler->getManager()->dev<RhAL::DXL>(entry.name));
+  }
+  return *entry.device;
+}
+
+void Helpers::setAngle(DofHandle dof, float angle)
+{
+  getDofDevice(dof).goalPosition().writeValue(angle);
+}
+
+float Helpers::getAngle(DofHandle dof)
+{
+  if (isFakeMode())
+  {
+    return getServices()->model->model.getDof(_dofs[dof].name);
+  }
+  else
+  {
+    RhAL::DXL& device = getDofDevice(dof);
+    if (device.dontRead())
+    {
+      // The servo is never read, we assume goal value
+      return device.goalPosition().getWrittenValue();
+    }
+    else
+    {
+      return device.position().readValue().value;
+    }
+  }
+}
+
+float Helpers::getGoalAngle(DofHandle dof)
+{
+  return getDofDevice(dof).goalPosition().getWrittenValue();
+}
+
+float Helpers::getError(DofHandle dof)
+{
+  if (isFakeMode())
+  {
+    return 0.0;
+  }
+  else
+  {
+    RhAL::DXL& device = getDofDevice(dof);
+    return device.position().readValue().value - device.goalPosition().getWrittenValue();
+  }
+}
+
+const std::vector<std::string>& Helpers::getLegDofNames()
+{
+  static const std::vector<std::string> names = {
+    "left_hip_yaw",  "left_hip_roll",  "left_hip_pitch",  "left_knee",  "left_ankle_pitch",  "left_ankle_roll",
+    "right_hip_yaw", "right_hip_roll", "right_hip_pitch", "right_knee", "right_ankle_pitch", "right_ankle_roll"
+  };
+  return names;
+}
+
+size_t Helpers::getLegIndex(const std::string& servo)
+{
+  const std::vector<std::string>& names = getLegDofNames();
+  auto it = std::find(names.begin(), names.end(), servo);
+  if (it == names.end())
+  {
+    throw std::out_of_range("Helpers::getLegIndex: '" + servo + "' is not a leg servo");
+  }
+  return it - names.begin();
+}
+
+void Helpers::setLegAngles(const LegAngles& angles)
+{
+  if (_legDofs.size() == 0)
+  {
+    for (const std::string& name : getLegDofNames())
+    {
+      _legDofs.push_back(getDofHandle(name));
+    }
+  }
+  for (size_t idx = 0; idx < angles.size(); idx++)
+  {
+    setAngle(_legDofs[idx], angles[idx]);
+  }
+}
+
 void Helpers::setFakeIMU(double yaw, double pitch, double roll)
 {
   Helpers::fakeYaw = yaw;
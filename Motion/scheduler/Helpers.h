@@ -1,13 +1,20 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <mutex>
+#include <vector>
 #include <RhIO.hpp>
 #include "services/Services.h"
 #include "moves/Moves.h"
 
 class MoveScheduler;
 
+namespace RhAL
+{
+class DXL;
+}
+
 /**
  * Helpers
  *
@@ -71,6 +78,50 @@ public:
   float getError(const std::string& servo);
   std::vector<std::string> getServoNames();
 
+  /**
+   * Handle on a servo, avoiding to look for the servo by its name at each
+   * access. Handles are only valid for the Helpers which created them
+   */
+  typedef size_t DofHandle;
+
+  /**
+   * Return the handle of the given servo. The name is resolved on the first
+   * access to the servo, therefore handles can be created in the constructor
+   * of the moves, before the low level is initialized
+   */
+  DofHandle getDofHandle(const std::string& servo);
+  const std::string& getDofName(DofHandle dof) const;
+
+  /**
+   * Helpers to access motors through their handles
+   */
+  virtual void setAngle(DofHandle dof, float angle);
+  float getAngle(DofHandle dof);
+  float getGoalAngle(DofHandle dof);
+  float getError(DofHandle dof);
+
+  /**
+   * Angles of the 12 leg servos [deg], in the order of getLegDofNames
+   */
+  typedef std::array<float, 12> LegAngles;
+
+  /**
+   * Names of the leg servos: hip yaw, hip roll, hip pitch, knee, ankle pitch
+   * and ankle roll of the left leg, then of the right leg
+   */
+  static const std::vector<std::string>& getLegDofNames();
+
+  /**
+   * Position of a leg servo in LegAngles, throws std::out_of_range if the
+   * servo is not a leg servo
+   */
+  static size_t getLegIndex(const std::string& servo);
+
+  /**
+   * Set the angles of all the leg servos at once
+   */
+  void setLegAngles(const LegAngles& angles);
+
   double getLastReadTimestamp();
 
   void lockScheduler();
@@ -119,4 +170,29 @@ private:
    * MoveScheduler main instance
    */
   MoveScheduler* _scheduler;
+
+  /**
+   * A servo accessed through a DofHandle
+   */
+  struct DofEntry
+  {
+    std::string name;
+    /// Resolved on first access, owned by the RhAL manager
+    RhAL::DXL* device;
+  };
+
+  /**
+   * Return the device of the servo, resolving it if needed
+   */
+  RhAL::DXL& getDofDevice(DofHandle dof);
+
+  /**
+   * Servos indexed by their handles
+   */
+  std::vector<DofEntry> _dofs;
+
+  /**
+   * Handles of the leg servos, created on first call to setLegAngles
+   */
+  std::vector<DofHandle> _legDofs;
 };
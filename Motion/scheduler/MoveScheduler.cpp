@@ -1,6 +1,11 @@
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#include <set>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -19,6 +24,26 @@ static rhoban_utils::Logger logger("MoveScheduler");
 // was done to avoid a big re-compile
 static Helpers helper;
 
+// Services which are not ticked when the scheduler is late, if enabled
+static const std::set<std::string> lateSkippableServices = { "teamPlay", "captain" };
+
+// Deadline misses are summarized at most once per period [ms]
+static const double deadlineReportPeriod = 1000;
+
+/**
+ * Write percentiles of an histogram in a cmdStats table row
+ */
+static void printHistogram(std::ostream& os, const std::string& name, const rhoban::LatencyHistogram& histogram)
+{
+  std::vector<double> percentiles = histogram.getPercentiles({ 0.5, 0.99, 0.999 });
+  os << std::setfill(' ') << std::setw(20) << name << std::setfill(' ') << std::setw(15)
+     << to_string(percentiles[0] * 1000) + "ms" << std::setfill(' ') << std::setw(15)
+     << to_string(percentiles[1] * 1000) + "ms" << std::setfill(' ') << std::setw(15)
+     << to_string(percentiles[2] * 1000) + "ms" << std::setfill(' ') << std::setw(15)
+     << to_string(histogram.getMax() * 1000) + "ms" << std::setfill(' ') << std::setw(15) << histogram.getCount()
+     << std::endl;
+}
+
 MoveScheduler::MoveScheduler()
   : _isOver(false)
   , _minTimeLoop(0.0)
@@ -34,6 +59,14 @@ MoveScheduler::MoveScheduler()
   , _avgTimeTickServices(0.0)
   , _maxTimeTickServices(0.0)
   , _manualClock(0.0)
+  , _flushPeriod(10.0)
+  , _deadlineMisses(0)
+  , _skippedTicks(0)
+  , _resetStats(false)
+  , _skipLateServices(false)
+  , _realtimePriority(0)
+  , _cpuAffinity(-1)
+  , _activeMovesChanged(true)
   , _manager()
   , _services(nullptr)
   , _moves(nullptr)
@@ -93,6 +126,36 @@ MoveScheduler::MoveScheduler()
 
   _bind->bindFunc("gyroTare", "Alias for rhalGyroTare", &MoveScheduler::cmdGyroTare, *this);
   _bind->bindFunc("stats", "MoveScheduler timing statistics", &MoveScheduler::cmdStats, *this);
+  _bind->bindFunc("resetStats", "Reset MoveScheduler real-time statistics", &MoveScheduler::cmdResetStats, *this);
+
+  // Real-time settings
+  _bind->bindNew("flushPeriod", _flushPeriod, RhIO::Bind::PullOnly)
+      ->defaultValue(_flushPeriod)
+      ->comment("Deadline of the ticks following a flush [ms]");
+  _bind->bindNew("skipLateServices", _skipLateServices, RhIO::Bind::PullOnly)
+      ->defaultValue(_skipLateServices)
+      ->comment("Skip non-critical services after a deadline miss");
+  _bind->bindNew("realtimePriority", _realtimePriority, RhIO::Bind::PullOnly)
+      ->defaultValue(_realtimePriority)
+      ->comment("SCHED_FIFO priority of the scheduler thread, 0 for default scheduling");
+  _bind->bindNew("cpuAffinity", _cpuAffinity, RhIO::Bind::PullOnly)
+      ->defaultValue(_cpuAffinity)
+      ->comment("CPU the scheduler thread is bound to, -1 for any");
+  _bind->bindNew("deadlineMisses", _deadlineMisses, RhIO::Bind::PushOnly)
+      ->defaultValue(0)
+      ->comment("Number of ticks not over before the next flush");
+  _bind->bindNew("skippedTicks", _skippedTicks, RhIO::Bind::PushOnly)
+      ->defaultValue(0)
+      ->comment("Number of service ticks skipped by the overrun policy");
+
+  for (size_t idx = 0; idx < _services->getAllServices().size(); idx++)
+  {
+    _servicesHistograms.emplace_back(new rhoban::LatencyHistogram());
+  }
+  for (size_t idx = 0; idx < _moves->getAllMoves().size(); idx++)
+  {
+    _movesHistograms.emplace_back(new rhoban::LatencyHistogram());
+  }
 }
 
 MoveScheduler::~MoveScheduler()
@@ -138,6 +201,24 @@ void MoveScheduler::stopAllMoves(double fade)
   }
 }
 
+void MoveScheduler::notifyMoveState()
+{
+  _activeMovesChanged = true;
+}
+
+void MoveScheduler::updateActiveMoves()
+{
+  _activeMoves.clear();
+  const auto& moves = _moves->getAllMoves();
+  for (size_t idx = 0; idx < moves.size(); idx++)
+  {
+    if (moves[idx].second->isRunning())
+    {
+      _activeMoves.push_back(idx);
+    }
+  }
+}
+
 void MoveScheduler::releaseServos()
 {
   _manager.emergencyStop();
@@ -158,6 +239,24 @@ void MoveScheduler::execute(bool manualClock)
   double lastManualClock = 0.0;
   double manualElapsed = 0.0;
 
+  // Real-time state
+  int appliedPriority = 0;
+  int appliedAffinity = -1;
+  bool late = false;
+  int unreportedMisses = 0;
+  double worstWork = 0;
+  TimeStamp firstUnreportedMiss = TimeStamp::now();
+  bool hasLastFlush = false;
+  TimeStamp lastFlush = TimeStamp::now();
+  TimeStamp lastTickMoves = TimeStamp::now();
+  const auto& services = _services->getAllServices();
+  const auto& moves = _moves->getAllMoves();
+  std::vector<bool> skippableServices;
+  for (const auto& service : services)
+  {
+    skippableServices.push_back(lateSkippableServices.count(service.first) > 0);
+  }
+
   while (!_isOver)
   {
     if (isFakeMode())
@@ -177,46 +276,123 @@ void MoveScheduler::execute(bool manualClock)
     }
     startLoop = TimeStamp::now();
 
+    // Real-time settings are applied from the scheduler thread
+    _bind->pull();
+    if (_realtimePriority != appliedPriority || _cpuAffinity != appliedAffinity)
+    {
+      applyRealtimeSettings();
+      appliedPriority = _realtimePriority;
+      appliedAffinity = _cpuAffinity;
+    }
+    if (_resetStats.exchange(false))
+    {
+      _periodHistogram.reset();
+      _workHistogram.reset();
+      for (auto& histogram : _servicesHistograms)
+      {
+        histogram->reset();
+      }
+      for (auto& histogram : _movesHistograms)
+      {
+        histogram->reset();
+      }
+      _deadlineMisses = 0;
+      _skippedTicks = 0;
+      hasLastFlush = false;
+    }
+
     // Wait next low level flush synchronisation
     TimeStamp startFlush = TimeStamp::now();
     _manager.waitNextFlush();
     TimeStamp stopFlush = TimeStamp::now();
+    if (hasLastFlush)
+    {
+      _periodHistogram.record(diffMs(lastFlush, stopFlush) / 1000.0);
+    }
+    lastFlush = stopFlush;
+    hasLastFlush = true;
+
+    // Overrun policy, elapsed times are not tracked with a manual clock
+    bool skipServices = late && _skipLateServices && !manualClock;
 
     mutex.lock();
     // Ticking services
     //(in defined orger by vector container)
     TimeStamp startTickServices = TimeStamp::now();
-    for (const auto& service : _services->getAllServices())
+    for (size_t idx = 0; idx < services.size(); idx++)
     {
+      if (skipServices && skippableServices[idx])
+      {
+        _skippedTicks++;
+        continue;
+      }
+      TimeStamp startTick = TimeStamp::now();
       if (manualClock)
       {
-        service.second->ElapseTick::tickElapsed(manualElapsed);
+        services[idx].second->ElapseTick::tickElapsed(manualElapsed);
       }
       else
       {
-        service.second->ElapseTick::tick();
+        services[idx].second->ElapseTick::tick();
       }
+      _servicesHistograms[idx]->record(diffMs(startTick, TimeStamp::now()) / 1000.0);
     }
     TimeStamp stopTickServices = TimeStamp::now();
 
-    // Ticking moves
+    // Ticking the running moves
     //(in defined orger by vector container)
+    if (_activeMovesChanged.exchange(false))
+    {
+      updateActiveMoves();
+    }
     TimeStamp startTickMoves = TimeStamp::now();
-    for (const auto& move : _moves->getAllMoves())
+    // Moves are not ticked while stopped, elapsed is the one of the loop
+    double elapsed = manualClock ? manualElapsed : diffMs(lastTickMoves, startTickMoves) / 1000.0;
+    lastTickMoves = startTickMoves;
+    for (int k = 0; k < (int)_activeMoves.size(); k++)
     {
-      // Ticking the move
-      if (manualClock)
+      size_t idx = _activeMoves[k];
+      TimeStamp startTick = TimeStamp::now();
+      moves[idx].second->ElapseTick::tickElapsed(elapsed);
+      _movesHistograms[idx]->record(diffMs(startTick, TimeStamp::now()) / 1000.0);
+
+      // Moves started during this tick are ticked in this loop if they come
+      // next in the order
+      if (_activeMovesChanged.exchange(false))
       {
-        move.second->ElapseTick::tickElapsed(manualElapsed);
-      }
-      else
-      {
-        move.second->ElapseTick::tick();
+        updateActiveMoves();
+        k = (std::upper_bound(_activeMoves.begin(), _activeMoves.end(), idx) - _activeMoves.begin()) - 1;
       }
     }
     TimeStamp stopTickMoves = TimeStamp::now();
+
+    // Publishing the state for other threads, they don't need the mutex
+    _services->publishSnapshots();
     mutex.unlock();
 
+    // The work following a flush has to be over before the next one
+    double durationWork = diffMs(stopFlush, stopTickMoves);
+    _workHistogram.record(durationWork / 1000.0);
+    late = durationWork > _flushPeriod;
+    if (late)
+    {
+      _deadlineMisses++;
+      if (unreportedMisses == 0)
+      {
+        firstUnreportedMiss = stopFlush;
+      }
+      unreportedMisses++;
+      worstWork = std::max(worstWork, durationWork);
+    }
+    if (unreportedMisses > 0 && diffMs(firstUnreportedMiss, stopTickMoves) > deadlineReportPeriod)
+    {
+      logger.error("move scheduler missed %d deadlines in the last %f ms, worst ticks took %f ms (period: %f ms)",
+                   unreportedMisses, diffMs(firstUnreportedMiss, stopTickMoves), worstWork, _flushPeriod);
+      unreportedMisses = 0;
+      worstWork = 0;
+    }
+    _bind->push();
+
     // Update statistics
     double durationFlush = diffMs(startFlush, stopFlush);
     double durationTickMoves = diffMs(startTickMoves, stopTickMoves);
@@ -306,6 +482,47 @@ RhAL::StandardManager* MoveScheduler::getManager()
   return &_manager;
 }
 
+void MoveScheduler::applyRealtimeSettings()
+{
+  struct sched_param param;
+  int policy = SCHED_OTHER;
+  param.sched_priority = 0;
+  if (_realtimePriority > 0)
+  {
+    policy = SCHED_FIFO;
+    param.sched_priority = _realtimePriority;
+  }
+  int err = pthread_setschedparam(pthread_self(), policy, &param);
+  if (err != 0)
+  {
+    logger.error("Can't set scheduler thread priority to %d: %s", _realtimePriority, strerror(err));
+  }
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (_cpuAffinity >= 0)
+  {
+    CPU_SET(_cpuAffinity, &cpus);
+  }
+  else
+  {
+    long nbCpus = sysconf(_SC_NPROCESSORS_CONF);
+    for (long cpu = 0; cpu < nbCpus && cpu < CPU_SETSIZE; cpu++)
+    {
+      CPU_SET(cpu, &cpus);
+    }
+  }
+  err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  if (err != 0)
+  {
+    logger.error("Can't bind scheduler thread to CPU %d: %s", _cpuAffinity, strerror(err));
+  }
+  else
+  {
+    logger.log("Scheduler thread priority: %d, CPU: %d", _realtimePriority, _cpuAffinity);
+  }
+}
+
 void MoveScheduler::askQuit()
 {
   _isOver = true;
@@ -456,6 +673,29 @@ std::string MoveScheduler::cmdStats()
          << to_string(entry.second->maxTime) + "ms" << std::endl;
     }
   }
+  os << "Real-time (deadline: " << to_string(_flushPeriod) << "ms, deadline misses: " << _deadlineMisses
+     << ", skipped service ticks: " << _skippedTicks << ")" << std::endl;
+  os << std::setfill(' ') << std::setw(20) << "Name" << std::setfill(' ') << std::setw(15) << "p50"
+     << std::setfill(' ') << std::setw(15) << "p99" << std::setfill(' ') << std::setw(15) << "p99.9"
+     << std::setfill(' ') << std::setw(15) << "max" << std::setfill(' ') << std::setw(15) << "count" << std::endl;
+  printHistogram(os, "Flush period:", _periodHistogram);
+  printHistogram(os, "Ticks after flush:", _workHistogram);
+  const auto& services = _services->getAllServices();
+  for (size_t idx = 0; idx < services.size(); idx++)
+  {
+    printHistogram(os, services[idx].first + ":", *_servicesHistograms[idx]);
+  }
+  const auto& moves = _moves->getAllMoves();
+  for (size_t idx = 0; idx < moves.size(); idx++)
+  {
+    printHistogram(os, moves[idx].first + ":", *_movesHistograms[idx]);
+  }
 
   return os.str();
 }
+
+std::string MoveScheduler::cmdResetStats()
+{
+  _resetStats = true;
+  return "Real-time statistics will be reset";
+}
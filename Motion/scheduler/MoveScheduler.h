@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 #include <RhIO.hpp>
 #include <RhAL.hpp>
 #include <Bindings/RhIOBinding.hpp>
@@ -10,6 +13,8 @@
 #include "services/Services.h"
 #include "services/Service.h"
 
+#include "utils/LatencyHistogram.h"
+
 class Move;
 class Services;
 
@@ -41,6 +46,12 @@ public:
   void stopMove(const std::string& name, double fade);
   void stopAllMoves(double fade);
 
+  /**
+   * Notify that a move was started or stopped, the set of active moves is
+   * updated before the next move tick
+   */
+  void notifyMoveState();
+
   /**
    * Emergency.
    * Disable all servos.
@@ -121,6 +132,65 @@ private:
   double _maxTimeTickServices;
   double _manualClock;
 
+  /**
+   * Real-time statistics: histograms of the durations between two flushes
+   * and of the work done after each flush, and histograms of each service
+   * and move tick (in ticking order)
+   */
+  rhoban::LatencyHistogram _periodHistogram;
+  rhoban::LatencyHistogram _workHistogram;
+  std::vector<std::unique_ptr<rhoban::LatencyHistogram>> _servicesHistograms;
+  std::vector<std::unique_ptr<rhoban::LatencyHistogram>> _movesHistograms;
+
+  /**
+   * Deadline of the work done after a flush [ms], it should match the
+   * period of the RhAL flushes
+   */
+  double _flushPeriod;
+
+  /**
+   * Number of ticks whose work was not over before the next flush and
+   * number of non-critical service ticks skipped
+   */
+  int _deadlineMisses;
+  int _skippedTicks;
+
+  /**
+   * Set by resetStats, statistics are reset by the scheduler thread
+   */
+  std::atomic<bool> _resetStats;
+
+  /**
+   * Overrun policy: when the previous tick missed its deadline, the
+   * non-critical services are not ticked
+   */
+  bool _skipLateServices;
+
+  /**
+   * SCHED_FIFO priority of the scheduler thread (0: default scheduling) and
+   * CPU it is bound to (-1: any)
+   */
+  int _realtimePriority;
+  int _cpuAffinity;
+
+  /**
+   * Apply _realtimePriority and _cpuAffinity to the calling thread
+   */
+  void applyRealtimeSettings();
+
+  /**
+   * Indexes in the moves container of the running moves, in ticking order.
+   * It is only used by the scheduler thread, other threads set
+   * _activeMovesChanged
+   */
+  std::vector<size_t> _activeMoves;
+  std::atomic<bool> _activeMovesChanged;
+
+  /**
+   * Rebuild _activeMoves from the moves states
+   */
+  void updateActiveMoves();
+
   /**
    * RhAL low level manager
    */
@@ -157,4 +227,5 @@ private:
   std::string cmdTare();
   std::string cmdGyroTare();
   std::string cmdStats();
+  std::string cmdResetStats();
 };
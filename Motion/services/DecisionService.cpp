@@ -440,3 +440,31 @@ bool DecisionService::tick(double elapsed)
 
   return true;
 }
+
+void DecisionService::publishSnapshot()
+{
+  DecisionSnapshot state;
+  state.isBallQualityGood = isBallQualityGood;
+  state.isBallMoving = isBallMoving;
+  state.hasMateKickedRecently = hasMateKickedRecently;
+  state.isMateKicking = isMateKicking;
+  state.isFieldQualityGood = isFieldQualityGood;
+  state.isFallen = isFallen;
+  state.shouldLetPlay = shouldLetPlay;
+  state.letPlayRadius = letPlayRadius;
+  state.ballIsShared = ballIsShared;
+  state.handled = handled;
+  state.freezeKick = freezeKick;
+  state.nextKickIsThrowIn = nextKickIsThrowIn;
+  state.isKickRunning = isKickRunning;
+  state.isThrowInRunning = isThrowInRunning;
+  state.fallDirection = fallDirection;
+  state.fallStatus = fallStatus;
+  state.camera_status = camera_status;
+  snapshot.publish(state);
+}
+
+std::shared_ptr<const DecisionSnapshot> DecisionService::getSnapshot() const
+{
+  return snapshot.get();
+}
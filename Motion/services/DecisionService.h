@@ -4,6 +4,7 @@
 #include <map>
 #include <RhAL.hpp>
 #include "services/Service.h"
+#include "services/Snapshot.h"
 #include <hl_communication/camera.pb.h>
 #include <rhoban_utils/history/history.h>
 
@@ -28,6 +29,30 @@ enum FallStatus : int
   Fallen = 2
 };
 
+/**
+ * Flags of the decision, published once per scheduler tick
+ */
+struct DecisionSnapshot
+{
+  bool isBallQualityGood = false;
+  bool isBallMoving = false;
+  bool hasMateKickedRecently = false;
+  bool isMateKicking = false;
+  bool isFieldQualityGood = false;
+  bool isFallen = false;
+  bool shouldLetPlay = false;
+  double letPlayRadius = 0;
+  bool ballIsShared = false;
+  bool handled = false;
+  bool freezeKick = false;
+  bool nextKickIsThrowIn = false;
+  bool isKickRunning = false;
+  bool isThrowInRunning = false;
+  FallDirection fallDirection = FallDirection::None;
+  FallStatus fallStatus = FallStatus::Ok;
+  hl_communication::FrameStatus camera_status = hl_communication::FrameStatus::UNKNOWN_FRAME_STATUS;
+};
+
 class DecisionService : public Service
 {
 public:
@@ -139,7 +164,15 @@ public:
 
   hl_communication::FrameStatus camera_status;
 
+  /**
+   * Snapshot of the flags, published by the scheduler after each tick
+   */
+  void publishSnapshot();
+  std::shared_ptr<const DecisionSnapshot> getSnapshot() const;
+
 protected:
+  Snapshot<DecisionSnapshot> snapshot;
+
   RhIO::Bind bind;
 
   // Thresholds for ball quality
@@ -460,14 +460,21 @@ std::vector<hl_communication::WeightedPose> LocalisationService::getPositionInCl
 }
 
 void LocalisationService::updatePosSelf()
+{
+  mutex.lock();
+  updateFieldState();
+  mutex.unlock();
+
+  bind.push();
+}
+
+void LocalisationService::updateFieldState()
 {
   updateFieldWorldTransforms();
   fieldOrientation = rad2deg(normalizeRad(getFieldOrientation()));
   auto fp = getFieldPos();
   fieldPosX = fp.x;
   fieldPosY = fp.y;
-
-  bind.push();
 }
 
 void LocalisationService::setPosSelf(const Eigen::Vector3d& center_in_self, float orientation, float quality,
@@ -480,6 +487,8 @@ void LocalisationService::setPosSelf(const Eigen::Vector3d& center_in_self, floa
 
   bind.pull();
 
+  // Called from the localisation thread, the scheduler reads these values when publishing its snapshot
+  mutex.lock();
   fieldQ = quality;
   fieldConsistency = consistency;
   consistencyEnabled = consistencyEnabled_;
@@ -491,7 +500,10 @@ void LocalisationService::setPosSelf(const Eigen::Vector3d& center_in_self, floa
 
   fieldOrientationWorld = atan2(field_dir_in_world.y(), field_dir_in_world.x());
 
-  updatePosSelf();
+  updateFieldState();
+  mutex.unlock();
+
+  bind.push();
 }
 
 void LocalisationService::applyKick(float x_, float y_)
@@ -667,7 +679,9 @@ std::string LocalisationService::cmdFakeLoc(double fieldX, double fieldY, double
 //      because it sets the robot at some world position and not field position
 std::string LocalisationService::cmdMoveOnField(double x, double y, double yaw)
 {
+  mutex.lock();
   fieldQ = 1;
+  mutex.unlock();
 
   // Computing the new selfInWorld target
   Eigen::Affine3d selfToWorld = Eigen::Affine3d::Identity();
@@ -751,6 +765,53 @@ bool LocalisationService::tick(double elapsed)
   return true;
 }
 
+void LocalisationService::publishSnapshot()
+{
+  LocalisationSnapshot state;
+  std::vector<Eigen::Vector3d> opponents;
+
+  // Field state is written by the localisation thread under the same mutex
+  mutex.lock();
+  state.ballPosWorld = ballPosWorld;
+  state.ballSpeed = ballSpeed;
+  state.ballTS = ballTS;
+  state.ballQ = ballQ;
+
+  state.fieldPos = getFieldPos();
+  state.fieldOrientation = getFieldOrientation();
+  state.fieldQ = fieldQ;
+  state.fieldConsistency = fieldConsistency;
+
+  state.field_from_world = field_from_world;
+  state.world_from_field = world_from_field;
+  state.self_from_world = self_from_world;
+  state.world_from_self = world_from_self;
+
+  opponents = opponentsWorld;
+  mutex.unlock();
+
+  Eigen::Vector3d ball_pos_self = state.self_from_world * state.ballPosWorld;
+  state.ballPosSelf = Point(ball_pos_self.x(), ball_pos_self.y());
+  Eigen::Vector3d ball_pos_field = state.field_from_world * state.ballPosWorld;
+  state.ballPosField = Point(ball_pos_field.x(), ball_pos_field.y());
+
+  for (const Eigen::Vector3d& opponent : opponents)
+  {
+    Eigen::Vector3d opponent_field = opponentsAreFake ? opponent : state.field_from_world * opponent;
+    state.opponentsField.push_back(Point(opponent_field.x(), opponent_field.y()));
+  }
+  state.opponentsRadius = opponentsRadius;
+  state.teamMatesField = getTeamMatesField();
+  state.sharedOpponents = getSharedOpponents();
+
+  snapshot.publish(state);
+}
+
+std::shared_ptr<const LocalisationSnapshot> LocalisationService::getSnapshot() const
+{
+  return snapshot.get();
+}
+
 void LocalisationService::updateFieldWorldTransforms()
 {
   Eigen::Matrix3d world_from_field_orientation;
@@ -761,7 +822,9 @@ void LocalisationService::updateFieldWorldTransforms()
 
 void LocalisationService::updateSelfWorldTransforms()
 {
-  world_from_self = getServices()->model->model.selfToWorld();
+  Eigen::Affine3d self_to_world = getServices()->model->model.selfToWorld();
+  std::lock_guard<std::mutex> lock(mutex);
+  world_from_self = self_to_world;
   self_from_world = world_from_self.inverse();
 }
 
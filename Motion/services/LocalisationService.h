@@ -2,6 +2,7 @@
 
 #include <RhIO.hpp>
 #include "Service.h"
+#include "services/Snapshot.h"
 
 #include <Eigen/Dense>
 #include <rhoban_geometry/point.h>
@@ -19,6 +20,36 @@ class FieldDistribution;
 
 }  // namespace Vision
 
+/// State of the localisation, published once per scheduler tick
+struct LocalisationSnapshot
+{
+  // Ball
+  Eigen::Vector3d ballPosWorld = Eigen::Vector3d::Zero();
+  rhoban_geometry::Point ballPosSelf;
+  rhoban_geometry::Point ballPosField;
+  rhoban_geometry::Point ballSpeed;  // In world referential
+  rhoban_utils::TimeStamp ballTS;
+  float ballQ = 0;
+
+  // Robot
+  rhoban_geometry::Point fieldPos;
+  double fieldOrientation = 0;
+  float fieldQ = 0;
+  float fieldConsistency = 0;
+
+  // Conversions between self, field and world referentials
+  Eigen::Affine3d field_from_world = Eigen::Affine3d::Identity();
+  Eigen::Affine3d world_from_field = Eigen::Affine3d::Identity();
+  Eigen::Affine3d self_from_world = Eigen::Affine3d::Identity();
+  Eigen::Affine3d world_from_self = Eigen::Affine3d::Identity();
+
+  // Opponents and team mates
+  std::vector<rhoban_geometry::Point> opponentsField;
+  double opponentsRadius = 0;
+  std::map<int, Eigen::Vector3d> teamMatesField;
+  std::vector<Eigen::Vector2d> sharedOpponents;
+};
+
 /// Unless explicitely stated otherwise, units are SI
 class LocalisationService : public Service
 {
@@ -168,10 +199,16 @@ public:
 
   bool isReplay;
 
+  /// Snapshot of the state, published by the scheduler after each tick
+  void publishSnapshot();
+  std::shared_ptr<const LocalisationSnapshot> getSnapshot() const;
+
 protected:
   // Mutex to access ball position
   std::mutex mutex;
 
+  Snapshot<LocalisationSnapshot> snapshot;
+
   // For fake mode
   hl_communication::WeightedPose fakeWeightedPose;
 
@@ -215,6 +252,11 @@ protected:
    */
   void updateFieldWorldTransforms();
 
+  /**
+   * Update the field transforms and the RhIO values of the robot position, mutex should be locked
+   */
+  void updateFieldState();
+
   /**
    * Update the basis transforms between self and world based on ModelService
    * - If fake mode is enabled, uses goalModel
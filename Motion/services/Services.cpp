@@ -65,6 +65,12 @@ const std::vector<std::pair<std::string, Service*>>& Services::getAllServices()
   return _container;
 }
 
+void Services::publishSnapshots()
+{
+  localisation->publishSnapshot();
+  decision->publishSnapshot();
+}
+
 void Services::add(const std::string& name, Service* service)
 {
   service->setScheduler(_scheduler);
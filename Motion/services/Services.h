@@ -44,6 +44,12 @@ public:
   Service* getService(const std::string& name);
   const std::vector<std::pair<std::string, Service*>>& getAllServices();
 
+  /**
+   * Publish the snapshots of the localisation and decision states,
+   * called by the scheduler once per tick
+   */
+  void publishSnapshots();
+
   /**
    * Direct access to services instance
    */
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+/**
+ * Snapshot
+ *
+ * Copy of a service state, published by the scheduler thread once per tick
+ * and read from other threads (vision, localisation, captain...) without
+ * locking the scheduler mutex.
+ *
+ * Each publication replaces the current copy (RCU-style), readers keep the
+ * copy they got for as long as they need it, thus all its fields are
+ * consistent with each other and publication never waits for readers.
+ */
+template <typename T>
+class Snapshot
+{
+public:
+  Snapshot() : _current(std::make_shared<const T>())
+  {
+  }
+
+  /**
+   * Replace the current copy, called by the scheduler thread
+   */
+  void publish(const T& value)
+  {
+    std::atomic_store(&_current, std::shared_ptr<const T>(std::make_shared<const T>(value)));
+  }
+
+  /**
+   * Return the last published copy, can be called from any thread
+   */
+  std::shared_ptr<const T> get() const
+  {
+    return std::atomic_load(&_current);
+  }
+
+private:
+  std::shared_ptr<const T> _current;
+};
@@ -0,0 +1,110 @@
+#include "utils/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rhoban
+{
+LatencyHistogram::LatencyHistogram()
+{
+  reset();
+}
+
+void LatencyHistogram::record(double duration)
+{
+  uint64_t max_us = (uint64_t(1) << max_bits) - 1;
+  uint64_t value = duration <= 0 ? 0 : std::min(max_us, (uint64_t)std::llround(duration * 1e6));
+  counts[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+  uint64_t current_max = max_value.load(std::memory_order_relaxed);
+  while (value > current_max && !max_value.compare_exchange_weak(current_max, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+void LatencyHistogram::reset()
+{
+  for (std::atomic<uint64_t>& count : counts)
+  {
+    count.store(0, std::memory_order_relaxed);
+  }
+  max_value.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getCount() const
+{
+  uint64_t total = 0;
+  for (const std::atomic<uint64_t>& count : counts)
+  {
+    total += count.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+double LatencyHistogram::getMax() const
+{
+  return max_value.load(std::memory_order_relaxed) * 1e-6;
+}
+
+double LatencyHistogram::getPercentile(double q) const
+{
+  return getPercentiles({ q })[0];
+}
+
+std::vector<double> LatencyHistogram::getPercentiles(const std::vector<double>& ratios) const
+{
+  // Copying counts first: samples might be recorded during the scan
+  std::vector<uint64_t> snapshot(nb_buckets);
+  uint64_t total = 0;
+  for (size_t bucket = 0; bucket < nb_buckets; bucket++)
+  {
+    snapshot[bucket] = counts[bucket].load(std::memory_order_relaxed);
+    total += snapshot[bucket];
+  }
+  std::vector<double> percentiles(ratios.size(), 0.0);
+  if (total == 0)
+  {
+    return percentiles;
+  }
+  uint64_t max_us = max_value.load(std::memory_order_relaxed);
+  uint64_t cumulated = 0;
+  size_t bucket = 0;
+  for (size_t idx = 0; idx < ratios.size(); idx++)
+  {
+    uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(ratios[idx] * total));
+    while (bucket < nb_buckets && cumulated + snapshot[bucket] < target)
+    {
+      cumulated += snapshot[bucket];
+      bucket++;
+    }
+    bucket = std::min(bucket, nb_buckets - 1);
+    // Upper bound of the bucket can not be above the highest value recorded
+    percentiles[idx] = std::min(getBucketUpperBound(bucket), max_us) * 1e-6;
+  }
+  return percentiles;
+}
+
+size_t LatencyHistogram::getBucket(uint64_t value)
+{
+  if (value < sub_buckets)
+  {
+    return value;
+  }
+  int highest_bit = 63 - __builtin_clzll(value);
+  int shift = highest_bit - sub_bucket_bits;
+  // sub_bucket is in [sub_buckets, 2 * sub_buckets[
+  uint64_t sub_bucket = value >> shift;
+  return sub_buckets * (shift + 1) + (sub_bucket - sub_buckets);
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(size_t bucket)
+{
+  if (bucket < sub_buckets)
+  {
+    return bucket;
+  }
+  int shift = bucket / sub_buckets - 1;
+  uint64_t sub_bucket = bucket % sub_buckets + sub_buckets;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+}  // namespace rhoban
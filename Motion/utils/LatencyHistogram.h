@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rhoban
+{
+/// Histogram of durations with a bounded relative error
+///
+/// Durations are counted with a resolution of one micro-second. Values are
+/// split in ranges [2^k, 2^(k+1)[ which are divided in 32 buckets, so the
+/// relative error on percentiles is below 1/32. Recording is lock-free and can
+/// be done from several threads. Durations above ~35 minutes are counted in
+/// the last bucket.
+class LatencyHistogram
+{
+public:
+  LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram& other) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram& other) = delete;
+
+  /// Add a sample [s]
+  void record(double duration);
+
+  /// Remove all the samples, samples recorded concurrently might be lost
+  void reset();
+
+  uint64_t getCount() const;
+
+  /// Return the maximal duration recorded [s]
+  double getMax() const;
+
+  /// Return the duration [s] below which the ratio 'q' of the samples lie, 0
+  /// if there is no sample
+  double getPercentile(double q) const;
+
+  /// Same as getPercentile for several ratios, in a single pass over the
+  /// buckets. 'ratios' have to be sorted in increasing order
+  std::vector<double> getPercentiles(const std::vector<double>& ratios) const;
+
+private:
+  /// Number of buckets in each range is 2^sub_bucket_bits
+  static constexpr int sub_bucket_bits = 5;
+  static constexpr uint64_t sub_buckets = 1 << sub_bucket_bits;
+  /// Values are clamped below 2^max_bits micro-seconds
+  static constexpr int max_bits = 31;
+  static constexpr size_t nb_buckets = sub_buckets * (max_bits - sub_bucket_bits + 1);
+
+  static size_t getBucket(uint64_t value);
+
+  /// Return the highest value [us] counted in the bucket
+  static uint64_t getBucketUpperBound(size_t bucket);
+
+  std::array<std::atomic<uint64_t>, nb_buckets> counts;
+  std::atomic<uint64_t> max_value;
+};
+
+}  // namespace rhoban
@@ -0,0 +1,3 @@
+set (SOURCES
+    LatencyHistogram.cpp
+)
@@ -0,0 +1,279 @@
+#include "Application/BatchReplay.hpp"
+
+#include "CameraState/CameraState.hpp"
+#include "Filters/Features/FeaturesProvider.hpp"
+#include "Filters/Pipeline.hpp"
+#include "FrameSource/Exceptions.hpp"
+#include "Utils/WorkerPool.hpp"
+
+#include <rhoban_utils/util.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+using namespace hl_monitoring;
+
+namespace Vision
+{
+namespace Application
+{
+namespace
+{
+/// Filters register themselves in the RhIO tree lazily during their first
+/// step, which is not thread-safe
+std::mutex rhio_mutex;
+
+/// Pipelines do not own the CameraState built by their sources, it is freed
+/// along with the pipeline
+struct PipelineDeleter
+{
+  void operator()(Pipeline* pipeline) const
+  {
+    delete pipeline->getCameraState();
+    delete pipeline;
+  }
+};
+
+/// Replace recursively all the occurrences of 'pattern' in the strings of 'v'
+void replaceInStrings(const std::string& pattern, const std::string& replacement, Json::Value* v)
+{
+  if (v->isString())
+  {
+    std::string str = v->asString();
+    size_t pos = str.find(pattern);
+    while (pos != std::string::npos)
+    {
+      str.replace(pos, pattern.size(), replacement);
+      pos = str.find(pattern, pos + replacement.size());
+    }
+    *v = str;
+  }
+  else if (v->isArray())
+  {
+    for (Json::ArrayIndex idx = 0; idx < v->size(); idx++)
+    {
+      replaceInStrings(pattern, replacement, &((*v)[idx]));
+    }
+  }
+  else if (v->isObject())
+  {
+    for (const std::string& key : v->getMemberNames())
+    {
+      replaceInStrings(pattern, replacement, &((*v)[key]));
+    }
+  }
+}
+
+Json::Value pointsToJson(const std::vector<cv::Point2f>& points)
+{
+  Json::Value v(Json::arrayValue);
+  for (const cv::Point2f& p : points)
+  {
+    Json::Value point(Json::arrayValue);
+    point.append(p.x);
+    point.append(p.y);
+    v.append(point);
+  }
+  return v;
+}
+
+/// Return the value at ratio 'q' of sorted values
+double getQuantile(const std::vector<double>& sorted_values, double q)
+{
+  if (sorted_values.size() == 0)
+  {
+    return 0;
+  }
+  return sorted_values[(size_t)(q * (sorted_values.size() - 1))];
+}
+
+struct TimingStats
+{
+  double mean, p50, p95, max;
+};
+
+TimingStats getTimingStats(std::vector<double> values)
+{
+  TimingStats stats = { 0, 0, 0, 0 };
+  if (values.size() == 0)
+  {
+    return stats;
+  }
+  std::sort(values.begin(), values.end());
+  double sum = 0;
+  for (double value : values)
+  {
+    sum += value;
+  }
+  stats.mean = sum / values.size();
+  stats.p50 = getQuantile(values, 0.5);
+  stats.p95 = getQuantile(values, 0.95);
+  stats.max = values.back();
+  return stats;
+}
+
+}  // namespace
+
+BatchReplay::BatchReplay(const std::string& pipeline_path, size_t nb_threads, int max_frames)
+  : pipeline_path(pipeline_path)
+  , pipeline_dir(rhoban_utils::getDirName(pipeline_path))
+  , pipeline_json(rhoban_utils::file2Json(pipeline_path))
+  , nb_threads(nb_threads)
+  , max_frames(max_frames)
+{
+}
+
+void BatchReplay::run(const std::vector<std::string>& log_dirs)
+{
+  results.clear();
+  results.resize(log_dirs.size());
+  // Building the pipelines declares their parameters in RhIO, this is done
+  // sequentially and only the steps are run concurrently
+  std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines(log_dirs.size());
+  for (size_t idx = 0; idx < log_dirs.size(); idx++)
+  {
+    LogResult* result = &(results[idx]);
+    result->log_dir = log_dirs[idx];
+    result->nb_frames = 0;
+    result->detections = Json::Value(Json::arrayValue);
+    try
+    {
+      pipelines[idx].reset(new Pipeline());
+      pipelines[idx]->fromJson(getPipelineDescription(result->log_dir), pipeline_dir);
+      pipelines[idx]->hideAllFilters();
+    }
+    catch (const std::exception& exc)
+    {
+      result->error = exc.what();
+      pipelines[idx].reset();
+    }
+  }
+  {
+    Utils::WorkerPool pool(nb_threads);
+    for (size_t idx = 0; idx < log_dirs.size(); idx++)
+    {
+      if (!pipelines[idx])
+      {
+        continue;
+      }
+      LogResult* result = &(results[idx]);
+      Pipeline* pipeline = pipelines[idx].get();
+      pool.push([this, result, pipeline]() { this->processLog(result, pipeline); });
+    }
+    // Destroying the pool waits for all the logs
+  }
+}
+
+const std::vector<BatchReplay::LogResult>& BatchReplay::getResults() const
+{
+  return results;
+}
+
+Json::Value BatchReplay::getPipelineDescription(const std::string& log_dir) const
+{
+  Json::Value v = pipeline_json;
+  replaceInStrings("$LOG_DIR", log_dir, &v);
+  return v;
+}
+
+void BatchReplay::processLog(LogResult* result, Pipeline* pipeline) const
+{
+  try
+  {
+    while (max_frames <= 0 || result->nb_frames < max_frames)
+    {
+      try
+      {
+        if (result->nb_frames == 0)
+        {
+          std::lock_guard<std::mutex> lock(rhio_mutex);
+          pipeline->step(Filter::UpdateType::forward);
+        }
+        else
+        {
+          pipeline->step(Filter::UpdateType::forward);
+        }
+      }
+      catch (const Utils::StreamEndException& exc)
+      {
+        break;
+      }
+      Json::Value frame_detections;
+      frame_detections["frame"] = result->nb_frames;
+      for (const auto& entry : pipeline->filters())
+      {
+        result->step_times[entry.first].push_back(entry.second->getLastStepTime());
+        const Filters::FeaturesProvider* provider = dynamic_cast<const Filters::FeaturesProvider*>(entry.second);
+        if (provider != nullptr)
+        {
+          Json::Value features;
+          features["balls"] = pointsToJson(provider->getBalls());
+          features["robots"] = pointsToJson(provider->getRobots());
+          for (const auto& poi_entry : provider->getPOIs())
+          {
+            features["pois"][Field::poiType2String(poi_entry.first)] = pointsToJson(poi_entry.second);
+          }
+          frame_detections["providers"][entry.first] = features;
+        }
+      }
+      result->detections.append(frame_detections);
+      result->nb_frames++;
+    }
+    pipeline->finish();
+  }
+  catch (const std::exception& exc)
+  {
+    result->error = exc.what();
+  }
+}
+
+void BatchReplay::writeJson(const std::string& path) const
+{
+  Json::Value v;
+  v["pipeline"] = pipeline_path;
+  v["logs"] = Json::Value(Json::arrayValue);
+  for (const LogResult& result : results)
+  {
+    Json::Value log_value;
+    log_value["logDir"] = result.log_dir;
+    log_value["nbFrames"] = result.nb_frames;
+    log_value["error"] = result.error;
+    for (const auto& entry : result.step_times)
+    {
+      TimingStats stats = getTimingStats(entry.second);
+      Json::Value& timing = log_value["timings"][entry.first];
+      timing["meanMs"] = 1000 * stats.mean;
+      timing["p50Ms"] = 1000 * stats.p50;
+      timing["p95Ms"] = 1000 * stats.p95;
+      timing["maxMs"] = 1000 * stats.max;
+    }
+    log_value["detections"] = result.detections;
+    v["logs"].append(log_value);
+  }
+  rhoban_utils::writeJson(v, path);
+}
+
+void BatchReplay::writeCsv(const std::string& path) const
+{
+  std::ofstream out(path);
+  if (!out.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to open file '" + path + "'");
+  }
+  out << "log,filter,nb_steps,mean_ms,p50_ms,p95_ms,max_ms" << std::endl;
+  for (const LogResult& result : results)
+  {
+    for (const auto& entry : result.step_times)
+    {
+      TimingStats stats = getTimingStats(entry.second);
+      out << result.log_dir << "," << entry.first << "," << entry.second.size() << "," << 1000 * stats.mean << ","
+          << 1000 * stats.p50 << "," << 1000 * stats.p95 << "," << 1000 * stats.max << std::endl;
+    }
+  }
+}
+
+}  // namespace Application
+}  // namespace Vision
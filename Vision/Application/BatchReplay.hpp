@@ -0,0 +1,81 @@
+#pragma once
+
+#include <json/json.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Vision
+{
+class Pipeline;
+
+namespace Application
+{
+/// Runs a pipeline over several logs without any display
+///
+/// Each log is processed by its own Pipeline, pipelines run concurrently on a
+/// pool of threads. In the pipeline description, every occurrence of
+/// '$LOG_DIR' inside a string is replaced by the directory of the log, this
+/// is used to configure the source filter.
+///
+/// Pipelines share the RhIO tree: they are built sequentially and their first
+/// steps are serialized, parameters should not be modified through RhIO
+/// during a batch. CameraStates are only available with sources of type
+/// Custom (e.g. SourceVideoProtobuf or SourceLogContainer) since no low-level
+/// model is available.
+class BatchReplay
+{
+public:
+  /// Results of the replay of a single log
+  struct LogResult
+  {
+    std::string log_dir;
+    /// Number of frames processed
+    int nb_frames;
+    /// Empty if the log was processed until the end of the stream
+    std::string error;
+    /// Step times of each filter [s]
+    std::map<std::string, std::vector<double>> step_times;
+    /// One entry per frame containing the features of each FeaturesProvider
+    Json::Value detections;
+  };
+
+  /// @param pipeline_path Path to the json description of the pipeline
+  /// @param nb_threads Number of logs processed simultaneously, 0 to use
+  ///        the number of hardware threads
+  /// @param max_frames Maximal number of frames per log, 0 for no limit
+  BatchReplay(const std::string& pipeline_path, size_t nb_threads, int max_frames);
+
+  /// Process all the logs and store their results, blocks until all the logs
+  /// have been processed
+  void run(const std::vector<std::string>& log_dirs);
+
+  const std::vector<LogResult>& getResults() const;
+
+  /// Write detections and timing statistics of all the logs
+  void writeJson(const std::string& path) const;
+
+  /// Write timing statistics with a line per log and per filter
+  void writeCsv(const std::string& path) const;
+
+private:
+  /// Process a single log with its own pipeline, never throws: errors are
+  /// stored in the result
+  void processLog(LogResult* result, Pipeline* pipeline) const;
+
+  /// Return the description of the pipeline with '$LOG_DIR' replaced
+  Json::Value getPipelineDescription(const std::string& log_dir) const;
+
+  std::string pipeline_path;
+  /// Directory of the pipeline description, used to solve relative paths
+  std::string pipeline_dir;
+  Json::Value pipeline_json;
+  size_t nb_threads;
+  int max_frames;
+
+  std::vector<LogResult> results;
+};
+
+}  // namespace Application
+}  // namespace Vision
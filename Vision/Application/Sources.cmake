@@ -1,3 +1,4 @@
 set(SOURCES
     Application.cpp
+    BatchReplay.cpp
 )
@@ -323,8 +323,8 @@ void LocalisationBinding::step()
   }
 
   // Determining if the robot is fallen
-  DecisionService* decisionService = scheduler->getServices()->decision;
-  if (decisionService->isFallen)
+  auto decision = scheduler->getServices()->decision->getSnapshot();
+  if (decision->isFallen)
   {
     if (debugLevel > 0)
     {
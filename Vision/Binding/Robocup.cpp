@@ -15,6 +15,7 @@
 
 #include "Filters/Features/FeaturesProvider.hpp"
 #include "Filters/Features/TagsDetector.hpp"
+#include "Filters/Source/SourceLogContainer.hpp"
 #include "Filters/Source/SourceVideoProtobuf.hpp"
 
 #include "CameraState/CameraState.hpp"
@@ -39,6 +40,7 @@
 #include "services/RefereeService.h"
 #include "services/ViveService.h"
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <sstream>
 #include <string>
@@ -81,6 +83,12 @@ Robocup::Robocup(MoveScheduler* scheduler)
   , game_logger("game_logs", false, max_images)
   , autolog_games(false)
   , logBallExtraTime(2.0)
+  , logQueueSize(0)
+  , logDropPolicy("dropNewest")
+  , logMemoryBudget(0)
+  , logCompression("jpg")
+  , logJpegQuality(90)
+  , logFormat("video")
   , writeBallStatus(false)
   , _scheduler(scheduler)
   , benchmark(false)
@@ -88,6 +96,7 @@ Robocup::Robocup(MoveScheduler* scheduler)
   , cs(new CameraState(scheduler))
   , activeSource(false)
   , clearRememberObservations(false)
+  , pipelineDepth(1)
   , detectedFeatures(new Field::POICollection())
   , detectedBalls(new std::vector<cv::Point3f>())
   , detectedRobots(new std::vector<cv::Point3f>())
@@ -133,19 +142,39 @@ Robocup::Robocup(MoveScheduler* scheduler)
   catch (const std::bad_cast& e)
   {
   }
+  try
+  {
+    Filters::SourceLogContainer& source_lc = dynamic_cast<Filters::SourceLogContainer&>(pipeline.get("human"));
+    source_lc.setScheduler(scheduler);
+  }
+  catch (const std::bad_cast& e)
+  {
+  }
   scheduler->getServices()->localisation->setRobocup(this);
+  _lateStagesThread = nullptr;
+  if (pipelineDepth > 1)
+  {
+    _lateStagesThread = new std::thread(std::bind(&Robocup::runLateStages, this));
+  }
   _runThread = new std::thread(std::bind(&Robocup::run, this));
 }
 
 Robocup::~Robocup()
 {
-  delete ballStackFilter;
   _doRun = false;
+  pendingFramesCond.notify_all();
   if (_runThread != NULL)
   {
     _runThread->join();
     delete _runThread;
   }
+  if (_lateStagesThread != nullptr)
+  {
+    _lateStagesThread->join();
+    delete _lateStagesThread;
+  }
+  // Threads are joined, nothing can use the filter anymore
+  delete ballStackFilter;
 }
 
 void Robocup::startLogging(unsigned int timeMS, const std::string& logDir)
@@ -163,6 +192,7 @@ void Robocup::endLogging()
   logMutex.lock();
   // Telling the low level to stop logging and to dump the info
   stopLoggingLowLevel(manual_logger.getSessionPath() + "/lowLevel.log");
+  manual_logger.attachHistories(manual_logger.getSessionPath() + "/lowLevel.log");
   manual_logger.endSession();
   // TODO: examine if logMutex can be closed earlier
   logMutex.unlock();
@@ -210,6 +240,13 @@ Json::Value Robocup::toJson() const
   v["logBallExtraTime"] = logBallExtraTime;
   v["writeBallStatus"] = writeBallStatus;
   v["ignoreOutOfFieldBalls"] = ignoreOutOfFieldBalls;
+  v["pipelineDepth"] = pipelineDepth;
+  v["logQueueSize"] = logQueueSize;
+  v["logDropPolicy"] = logDropPolicy;
+  v["logMemoryBudget"] = logMemoryBudget;
+  v["logCompression"] = logCompression;
+  v["logJpegQuality"] = logJpegQuality;
+  v["logFormat"] = logFormat;
   v["feature_providers"] = vector2Json(featureProviders);
   for (const SpecialImageHandler& sih : imageHandlers)
   {
@@ -229,6 +266,68 @@ void Robocup::fromJson(const Json::Value& v, const std::string& dir_name)
   rhoban_utils::tryRead(v, "logBallExtraTime", &logBallExtraTime);
   rhoban_utils::tryRead(v, "writeBallStatus", &writeBallStatus);
   rhoban_utils::tryRead(v, "ignoreOutOfFieldBalls", &ignoreOutOfFieldBalls);
+  rhoban_utils::tryRead(v, "pipelineDepth", &pipelineDepth);
+  if (pipelineDepth < 1)
+  {
+    throw rhoban_utils::JsonParsingError(DEBUG_INFO + " pipelineDepth should be strictly positive");
+  }
+  rhoban_utils::tryRead(v, "logQueueSize", &logQueueSize);
+  rhoban_utils::tryRead(v, "logDropPolicy", &logDropPolicy);
+  ImageLogger::DropPolicy drop_policy;
+  if (logDropPolicy == "dropNewest")
+  {
+    drop_policy = ImageLogger::DropPolicy::DropNewest;
+  }
+  else if (logDropPolicy == "block")
+  {
+    drop_policy = ImageLogger::DropPolicy::Block;
+  }
+  else
+  {
+    throw rhoban_utils::JsonParsingError(DEBUG_INFO + " unknown logDropPolicy '" + logDropPolicy + "'");
+  }
+  if (logQueueSize < 0)
+  {
+    throw rhoban_utils::JsonParsingError(DEBUG_INFO + " logQueueSize should be positive");
+  }
+  rhoban_utils::tryRead(v, "logMemoryBudget", &logMemoryBudget);
+  rhoban_utils::tryRead(v, "logCompression", &logCompression);
+  rhoban_utils::tryRead(v, "logJpegQuality", &logJpegQuality);
+  if (logMemoryBudget < 0)
+  {
+    throw rhoban_utils::JsonParsingError(DEBUG_INFO + " logMemoryBudget should be positive");
+  }
+  if (logCompression != "jpg" && logCompression != "png")
+  {
+    throw rhoban_utils::JsonParsingError(DEBUG_INFO + " unknown logCompression '" + logCompression + "'");
+  }
+  // Automatic logs use compressed storage if a budget is provided, the writer
+  // thread otherwise. Manual logs are explicitly requested and always use the
+  // writer thread
+  for (ImageLogger* logger : { &manual_logger, &moving_ball_logger, &game_logger })
+  {
+    bool compressed = logMemoryBudget > 0 && logger != &manual_logger;
+    // Both modes are exclusive: disabling one before enabling the other
+    if (compressed)
+    {
+      logger->setAsync(0, drop_policy);
+      logger->setCompressedStorage((size_t)logMemoryBudget * 1024 * 1024, "." + logCompression, logJpegQuality);
+    }
+    else
+    {
+      logger->setCompressedStorage(0, "." + logCompression, logJpegQuality);
+      logger->setAsync(logQueueSize, drop_policy);
+    }
+  }
+  rhoban_utils::tryRead(v, "logFormat", &logFormat);
+  if (logFormat != "video" && logFormat != "container")
+  {
+    throw rhoban_utils::JsonParsingError(DEBUG_INFO + " unknown logFormat '" + logFormat + "'");
+  }
+  for (ImageLogger* logger : { &manual_logger, &moving_ball_logger, &game_logger })
+  {
+    logger->setContainerOutput(logFormat == "container", "." + logCompression, logJpegQuality);
+  }
   rhoban_utils::tryReadVector<std::string>(v, "featureProviders", &featureProviders);
   for (SpecialImageHandler& sih : imageHandlers)
   {
@@ -312,6 +411,24 @@ void Robocup::initRhIO()
                             return "Filters are now hidden";
                           });
   }
+  RhIO::Root.newCommand("Vision/latencies", "Percentiles of the durations of the pipeline stages and filters",
+                        [this](const std::vector<std::string>& args) -> std::string {
+                          return pipeline.dumpLatencies();
+                        });
+  RhIO::Root.newCommand("Vision/resetLatencies", "Remove the durations recorded for the pipeline stages and filters",
+                        [this](const std::vector<std::string>& args) -> std::string {
+                          pipeline.resetLatencies();
+                          return "Latencies have been reset";
+                        });
+  for (const std::string& stage : pipeline.getStages())
+  {
+    for (const std::string& stat : { "p50", "p95", "p99", "max" })
+    {
+      RhIO::Root.newFloat("/Vision/latency_" + stage + "_" + stat)
+          ->defaultValue(0)
+          ->comment("Duration of the stage '" + stage + "' of the pipeline [ms]");
+    }
+  }
   RhIO::Root.newCommand("Vision/logLocal",
                         "Starts logging for a specified duration. Images are "
                         "saved on board for now.",
@@ -338,7 +455,26 @@ void Robocup::initRhIO()
   RhIO::Root.newBool("/Vision/autologGames")
       ->defaultValue(autolog_games)
       ->comment("If enabled, write logs while game is playing");
+  for (const std::string& logger_name : { "manualLogs", "movingBallLogs", "gameLogs" })
+  {
+    RhIO::Root.newInt("/Vision/" + logger_name + "QueueDepth")
+        ->defaultValue(0)
+        ->comment("Number of images waiting for the writer thread");
+    RhIO::Root.newInt("/Vision/" + logger_name + "Dropped")
+        ->defaultValue(0)
+        ->comment("Number of images dropped in current session because the writer thread was late");
+  }
   RhIO::Root.newBool("/Vision/benchmark")->defaultValue(benchmark)->comment("Is logging activated ?");
+  RhIO::Root.newInt("/Vision/framePoolAllocations")
+      ->defaultValue(0)
+      ->comment("Number of output images allocated by the frame pool during the last step");
+  RhIO::Root.newInt("/Vision/framePoolReuses")
+      ->defaultValue(0)
+      ->comment("Number of output images reused from the frame pool during the last step");
+  RhIO::Root.newInt("/Vision/frameArenaAllocations")
+      ->defaultValue(0)
+      ->comment("Number of scratch buffers allocated by the frame arenas during the last step");
+  RhIO::Root.newChild("Vision/stepTimes");
   RhIO::Root.newInt("/Vision/benchmarkDetail")->defaultValue(benchmarkDetail)->comment("Depth of print for benchmark");
   RhIO::Root.newFloat("/Vision/motorDelay")
       ->defaultValue(CameraState::motor_delay)
@@ -386,7 +522,7 @@ void Robocup::step()
 
   // Sometimes vision is useless and even bug prone, in this case, cancel the
   // step
-  DecisionService* decision = _scheduler->getServices()->decision;
+  auto decision = _scheduler->getServices()->decision->getSnapshot();
   bool handled = decision->handled;
   bool fallen = decision->isFallen;
   if (embedded && (handled || fallen))
@@ -444,6 +580,13 @@ void Robocup::step()
 
   // Making sure the image delay is given to the pipeline
   importFromRhIO();
+
+  if (pipelineDepth > 1)
+  {
+    stepEarlyStages();
+    return;
+  }
+
   Benchmark::open("Vision + Localisation");
 
   Benchmark::open("Waiting for global mutex");
@@ -451,39 +594,14 @@ void Robocup::step()
   Benchmark::close("Waiting for global mutex");
 
   Benchmark::open("Pipeline");
-  try
-  {
-    Application::step();
-    activeSource = true;
-    // If Vision application has finished, ask for scheduler to shut down
-    if (!isActive())
-    {
-      out.log("Vision exiting, asking to scheduler to shut down");
-      _scheduler->askQuit();
-    }
-  }
-  catch (const PtGreyException& exc)
-  {
-    globalMutex.unlock();
-    Benchmark::close("Pipeline");
-    Benchmark::close("Vision + Localisation", benchmark, benchmarkDetail);
-    activeSource = false;
-    out.warning("Failed vision step: '%s'", exc.what());
-    publishToRhIO();
-    int sleep_time_ms = 100;
-    usleep(sleep_time_ms * 1000);
-    return;
-  }
-  catch (const PtGreyConnectionException& exc)
+  int failure_sleep_ms = runPipelineStep();
+  if (failure_sleep_ms > 0)
   {
     globalMutex.unlock();
     Benchmark::close("Pipeline");
     Benchmark::close("Vision + Localisation", benchmark, benchmarkDetail);
-    activeSource = false;
-    out.warning("Failed to connect to camera: '%s'", exc.what());
     publishToRhIO();
-    int sleep_time_ms = 500;
-    usleep(sleep_time_ms * 1000);
+    usleep(failure_sleep_ms * 1000);
     return;
   }
   Benchmark::close("Pipeline");
@@ -509,6 +627,62 @@ void Robocup::step()
 
   globalMutex.unlock();
 
+  updateImageHandlers();
+
+  Benchmark::open("Waiting for global mutex");
+  globalMutex.lock();
+  Benchmark::close("Waiting for global mutex");
+
+  treatmentDelay = diffMs(sourceTS, TimeStamp::now());
+  publishToRhIO();
+
+  Benchmark::close("Tagging & Display");
+
+  globalMutex.unlock();
+
+  Benchmark::close("Vision + Localisation", benchmark, benchmarkDetail);
+
+  publishPipelineStats();
+
+  // Set the log timestamp during fake mode
+  if (isFakeMode())
+  {
+    double ts = pipeline.getCameraState()->getTimeStampDouble();
+    _scheduler->getServices()->model->setReplayTimestamp(ts);
+  }
+}
+
+int Robocup::runPipelineStep()
+{
+  try
+  {
+    Application::step();
+    activeSource = true;
+    publishLatencies();
+    // If Vision application has finished, ask for scheduler to shut down
+    if (!isActive())
+    {
+      out.log("Vision exiting, asking to scheduler to shut down");
+      _scheduler->askQuit();
+    }
+  }
+  catch (const PtGreyException& exc)
+  {
+    activeSource = false;
+    out.warning("Failed vision step: '%s'", exc.what());
+    return 100;
+  }
+  catch (const PtGreyConnectionException& exc)
+  {
+    activeSource = false;
+    out.warning("Failed to connect to camera: '%s'", exc.what());
+    return 500;
+  }
+  return 0;
+}
+
+void Robocup::updateImageHandlers()
+{
   for (SpecialImageHandler& sih : imageHandlers)
   {
     std::string prefix = "Vision/" + sih.name;
@@ -527,6 +701,140 @@ void Robocup::step()
       RhIO::Root.framePush(prefix, sih.lastImg);
     Benchmark::close(sih.name.c_str());
   }
+}
+
+void Robocup::publishPipelineStats()
+{
+  RhIO::Root.setInt("/Vision/framePoolAllocations", pipeline.getLastStepAllocations());
+  RhIO::Root.setInt("/Vision/framePoolReuses", pipeline.getLastStepReuses());
+  RhIO::Root.setInt("/Vision/frameArenaAllocations", pipeline.getLastStepScratchAllocations());
+  if (!benchmark)
+  {
+    return;
+  }
+  // Filters processed by the worker pool are not part of the benchmark tree,
+  // the durations of all the filters are published instead
+  RhIO::IONode& stepTimesNode = RhIO::Root.child("Vision/stepTimes");
+  for (const auto& entry : pipeline.getLastStepTimes())
+  {
+    if (stepTimesNode.getValueType(entry.first) == RhIO::NoValue)
+    {
+      stepTimesNode.newFloat(entry.first)->defaultValue(0)->comment("Duration of the last step of the filter [ms]");
+    }
+    stepTimesNode.setFloat(entry.first, 1000 * entry.second);
+  }
+}
+
+void Robocup::stepEarlyStages()
+{
+  Benchmark::open("Vision (early stages)");
+
+  // globalMutex is not required here: the late stages only access the
+  // pipeline through the frames extracted below
+  Benchmark::open("Waiting for vision mutex");
+  visionMutex.lock();
+  Benchmark::close("Waiting for vision mutex");
+
+  Benchmark::open("Pipeline");
+  int failure_sleep_ms = runPipelineStep();
+  if (failure_sleep_ms > 0)
+  {
+    visionMutex.unlock();
+    Benchmark::close("Pipeline");
+    Benchmark::close("Vision (early stages)", benchmark, benchmarkDetail);
+    publishToRhIO();
+    usleep(failure_sleep_ms * 1000);
+    return;
+  }
+  Benchmark::close("Pipeline");
+
+  Benchmark::open("Extracting frame");
+  std::unique_ptr<PipelineFrame> frame(new PipelineFrame());
+  frame->cs = *pipeline.getCameraState();
+  frame->pipeline_ts = pipeline.getTimestamp();
+  // Cloning is required since the filter buffers are reused by the next steps
+  frame->log_img = pipeline.get("human").getImg()->clone();
+  collectFeatures(&(frame->features));
+  visionMutex.unlock();
+  Benchmark::close("Extracting frame");
+
+  publishPipelineStats();
+
+  // Waiting if the late stages are lagging behind, it ensures that latency
+  // cannot grow above 'pipelineDepth' frames
+  Benchmark::open("Waiting for late stages");
+  {
+    std::unique_lock<std::mutex> lock(pendingFramesMutex);
+    pendingFramesCond.wait(lock,
+                           [this]() { return !_doRun || (int)pendingFrames.size() < pipelineDepth - 1; });
+    pendingFrames.push_back(std::move(frame));
+  }
+  pendingFramesCond.notify_all();
+  Benchmark::close("Waiting for late stages");
+
+  Benchmark::close("Vision (early stages)", benchmark, benchmarkDetail);
+}
+
+void Robocup::runLateStages()
+{
+  while (_doRun)
+  {
+    std::unique_ptr<PipelineFrame> frame;
+    {
+      std::unique_lock<std::mutex> lock(pendingFramesMutex);
+      // Timeout is used to check _doRun regularly
+      pendingFramesCond.wait_for(lock, std::chrono::milliseconds(100),
+                                 [this]() { return !_doRun || pendingFrames.size() > 0; });
+      if (pendingFrames.size() == 0)
+      {
+        continue;
+      }
+      frame = std::move(pendingFrames.front());
+      pendingFrames.pop_front();
+    }
+    pendingFramesCond.notify_all();
+    stepLateStages(std::move(frame));
+  }
+}
+
+void Robocup::stepLateStages(std::unique_ptr<PipelineFrame> frame)
+{
+  Benchmark::open("Localisation (late stages)");
+
+  Benchmark::open("Waiting for global mutex");
+  globalMutex.lock();
+  Benchmark::close("Waiting for global mutex");
+
+  Benchmark::open("readPipeline");
+  // The previous frame is released only once every user of 'cs' has been updated
+  std::unique_ptr<PipelineFrame> previous_frame = std::move(currentFrame);
+  currentFrame = std::move(frame);
+  updateCameraState(&(currentFrame->cs));
+  previous_frame.reset();
+  importFeatures(currentFrame->features);
+  Benchmark::close("readPipeline");
+
+  Benchmark::open("loggingStep");
+  ImageLogger::Entry entry;
+  entry.img = currentFrame->log_img;
+  entry.time_stamp = (uint64_t)(currentFrame->pipeline_ts.getTimeSec() * std::pow(10, 6));
+  entry.cs = *cs;
+  loggingStep(entry);
+  Benchmark::close("loggingStep");
+
+  Benchmark::open("BallInformations");
+  updateBallInformations();
+  Benchmark::close("BallInformations");
+
+  Benchmark::open("RobotInformations");
+  updateRobotInformations();
+  Benchmark::close("RobotInformations");
+
+  Benchmark::open("Tagging & Display");
+
+  globalMutex.unlock();
+
+  updateImageHandlers();
 
   Benchmark::open("Waiting for global mutex");
   globalMutex.lock();
@@ -537,14 +845,15 @@ void Robocup::step()
 
   Benchmark::close("Tagging & Display");
 
+  double ts = cs->getTimeStampDouble();
+
   globalMutex.unlock();
 
-  Benchmark::close("Vision + Localisation", benchmark, benchmarkDetail);
+  Benchmark::close("Localisation (late stages)", benchmark, benchmarkDetail);
 
   // Set the log timestamp during fake mode
   if (isFakeMode())
   {
-    double ts = pipeline.getCameraState()->getTimeStampDouble();
     _scheduler->getServices()->model->setReplayTimestamp(ts);
   }
 }
@@ -572,6 +881,35 @@ void Robocup::publishToRhIO()
   RhIO::Root.setFloat("/Vision/lastUpdate", diffMs(lastTS, getNowTS()));
   std::string cameraStatus = getCameraStatus();
   RhIO::Root.setStr("/Vision/cameraStatus", cameraStatus);
+  std::vector<std::pair<std::string, const ImageLogger*>> loggers = {
+    { "manualLogs", &manual_logger }, { "movingBallLogs", &moving_ball_logger }, { "gameLogs", &game_logger }
+  };
+  for (const auto& entry : loggers)
+  {
+    RhIO::Root.setInt("/Vision/" + entry.first + "QueueDepth", entry.second->getQueueDepth());
+    RhIO::Root.setInt("/Vision/" + entry.first + "Dropped", entry.second->getDroppedEntries());
+  }
+}
+
+void Robocup::publishLatencies()
+{
+  TimeStamp now = TimeStamp::now();
+  if (diffMs(lastLatenciesPublication, now) < latenciesPublicationPeriod)
+  {
+    return;
+  }
+  lastLatenciesPublication = now;
+  for (const std::string& stage : pipeline.getStages())
+  {
+    const rhoban::LatencyHistogram& histogram = pipeline.getStageLatencies(stage);
+    std::vector<double> percentiles = histogram.getPercentiles({ 0.5, 0.95, 0.99 });
+    std::string prefix = "/Vision/latency_" + stage + "_";
+    RhIO::Root.setFloat(prefix + "p50", 1000 * percentiles[0]);
+    RhIO::Root.setFloat(prefix + "p95", 1000 * percentiles[1]);
+    RhIO::Root.setFloat(prefix + "p99", 1000 * percentiles[2]);
+    RhIO::Root.setFloat(prefix + "max", 1000 * histogram.getMax());
+  }
+  pipeline.publishLatencies();
 }
 
 std::string Robocup::getCameraStatus() const
@@ -580,7 +918,7 @@ std::string Robocup::getCameraStatus() const
   {
     return "Connection lost";
   }
-  DecisionService* decision = _scheduler->getServices()->decision;
+  auto decision = _scheduler->getServices()->decision->getSnapshot();
   if (decision->handled || decision->isFallen)
   {
     return "Inactive (handled or fallen)";
@@ -589,27 +927,57 @@ std::string Robocup::getCameraStatus() const
 }
 
 void Robocup::readPipeline()
+{
+  std::vector<FeaturesInImg> features;
+  collectFeatures(&features);
+  importFeatures(features);
+}
+
+void Robocup::collectFeatures(std::vector<FeaturesInImg>* features)
+{
+  features->clear();
+  for (const auto& provider_name : featureProviders)
+  {
+    try
+    {
+      const Filters::FeaturesProvider& provider =
+          dynamic_cast<const Filters::FeaturesProvider&>(pipeline.get(provider_name));
+      FeaturesInImg provider_features;
+      provider_features.provider_name = provider_name;
+      provider_features.balls = provider.getBalls();
+      provider_features.pois = provider.getPOIs();
+      provider_features.robots = provider.getRobots();  // TODO: add robot info (color)
+      features->push_back(provider_features);
+    }
+    catch (const std::bad_cast& e)
+    {
+      out.error("%s: Failed to import features, check pipeline. Exception: %s", DEBUG_INFO.c_str(), e.what());
+    }
+    catch (const std::runtime_error& exc)
+    {
+      out.error("%s: Failed to import features, runtime_error. Exception: %s", DEBUG_INFO.c_str(), exc.what());
+    }
+  }
+}
+
+void Robocup::importFeatures(const std::vector<FeaturesInImg>& features)
 {
   featuresMutex.lock();
   // Ball and robots are cleared after every step (used internally)
   detectedBalls->clear();
   detectedRobots->clear();
-  for (const auto& provider_name : featureProviders)
+  for (const FeaturesInImg& provider_features : features)
   {
     try
     {
-      const Filters::FeaturesProvider& provider =
-          dynamic_cast<const Filters::FeaturesProvider&>(pipeline.get(provider_name));
       // Balls import
-      std::vector<cv::Point2f> balls_in_img = provider.getBalls();
-      for (const cv::Point2f& ball_in_img : balls_in_img)
+      for (const cv::Point2f& ball_in_img : provider_features.balls)
       {
         Eigen::Vector3d ball_pos = cs->ballInWorldFromPixel(ball_in_img);
         detectedBalls->push_back(eigen2CV(ball_pos));
       }
       // POI update
-      std::map<Field::POIType, std::vector<cv::Point2f>> pois_in_img = provider.getPOIs();
-      for (const auto& entry : pois_in_img)
+      for (const auto& entry : provider_features.pois)
       {
         Field::POIType poi_type = entry.first;
         for (const cv::Point2f& feature_pos_in_img : entry.second)
@@ -619,20 +987,16 @@ void Robocup::readPipeline()
         }
       }
       // Robot import
-      std::vector<cv::Point2f> robots_in_img = provider.getRobots();  // TODO: add robot info (color)
-      for (const cv::Point2f& robot_in_img : robots_in_img)
+      for (const cv::Point2f& robot_in_img : provider_features.robots)
       {
         cv::Point2f world_pos = cs->worldPosFromImg(robot_in_img.x, robot_in_img.y);
         detectedRobots->push_back(cv::Point3f(world_pos.x, world_pos.y, 0));
       }
     }
-    catch (const std::bad_cast& e)
-    {
-      out.error("%s: Failed to import features, check pipeline. Exception: %s", DEBUG_INFO.c_str(), e.what());
-    }
     catch (const std::runtime_error& exc)
     {
-      out.error("%s: Failed to import features, runtime_error. Exception: %s", DEBUG_INFO.c_str(), exc.what());
+      out.error("%s: Failed to import features from '%s', runtime_error. Exception: %s", DEBUG_INFO.c_str(),
+                provider_features.provider_name.c_str(), exc.what());
     }
   }
   featuresMutex.unlock();
@@ -696,17 +1060,22 @@ void Robocup::readPipeline()
 }
 
 void Robocup::getUpdatedCameraStateFromPipeline()
+{
+  // EXPERIMENTAL:
+  //
+  // modification linked to the possibility that 'Source' filter provides the
+  // cameraState (from SourceVideoProtobuf)
+  updateCameraState(pipeline.getCameraState());
+}
+
+void Robocup::updateCameraState(CameraState* new_cs)
 {
   csMutex.lock();
 
   // Backup values
   lastTS = sourceTS;
 
-  // EXPERIMENTAL:
-  //
-  // modification linked to the possibility that 'Source' filter provides the
-  // cameraState (from SourceVideoProtobuf)
-  cs = pipeline.getCameraState();
+  cs = new_cs;
   ballStackFilter->updateCS(cs);
   robotFilter->updateCS(cs);
 
@@ -727,17 +1096,21 @@ void Robocup::getUpdatedCameraStateFromPipeline()
 
 void Robocup::loggingStep()
 {
-  TimeStamp now = getNowTS();
-
-  DecisionService* decision = _scheduler->getServices()->decision;
-  RefereeService* referee = _scheduler->getServices()->referee;
-
   // Capture src_filter and throws a std::runtime_error if required
   const Filter& src_filter = pipeline.get("human");
   ImageLogger::Entry entry;
   entry.img = *(src_filter.getImg());
   entry.time_stamp = (uint64_t)(pipeline.getTimestamp().getTimeSec() * std::pow(10, 6));
   entry.cs = *cs;
+  loggingStep(entry);
+}
+
+void Robocup::loggingStep(const ImageLogger::Entry& entry)
+{
+  TimeStamp now = getNowTS();
+
+  DecisionService* decision = _scheduler->getServices()->decision;
+  RefereeService* referee = _scheduler->getServices()->referee;
 
   logMutex.lock();
   // Handling manual logs
@@ -830,12 +1203,14 @@ void Robocup::loggingStep()
   {
     std::string lowLevelPath = moving_ball_logger.getSessionPath() + "/lowLevel.log";
     stopLoggingLowLevel(lowLevelPath);
+    moving_ball_logger.attachHistories(lowLevelPath);
     moving_ball_logger.endSession();
   }
   if (stopGameLog)
   {
     std::string lowLevelPath = game_logger.getSessionPath() + "/lowLevel.log";
     stopLoggingLowLevel(lowLevelPath);
+    game_logger.attachHistories(lowLevelPath);
     game_logger.endSession();
   }
 }
@@ -1404,6 +1779,37 @@ void Robocup::ballReset(float x, float y)
 
 void Robocup::setLogMode(const std::string& path)
 {
+  std::string extension = ".rhl";
+  if (path.size() > extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+  {
+    Utils::LogContainerReader reader(path);
+    if (!reader.hasHistories())
+    {
+      throw std::runtime_error(DEBUG_INFO + " log container '" + path +
+                               "' has no low-level histories, it was recorded without low-level logging");
+    }
+    // Histories are loaded from a file, a temporary one is used to leave the log directory untouched
+    char histories_path[] = "/tmp/kid_size_histories_XXXXXX";
+    int fd = mkstemp(histories_path);
+    if (fd < 0)
+    {
+      throw std::runtime_error(DEBUG_INFO + " failed to create a temporary file for the histories of '" + path + "'");
+    }
+    close(fd);
+    try
+    {
+      reader.extractHistories(histories_path);
+      _scheduler->getServices()->model->loadReplay(histories_path);
+    }
+    catch (...)
+    {
+      std::remove(histories_path);
+      throw;
+    }
+    std::remove(histories_path);
+    out.log("Loaded replay from log container '%s'", path.c_str());
+    return;
+  }
   _scheduler->getServices()->model->loadReplay(path);
 
   std::cout << "Loaded replay" << std::endl;
@@ -13,6 +13,9 @@
 #include <rhoban_utils/timing/time_stamp.h>
 
 #include <Eigen/Core>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <utility>
 #include <string>
 #include <vector>
@@ -84,6 +87,27 @@ private:
   /// Keep logging for a while after ball stopped moving [s]
   float logBallExtraTime;
 
+  /// Size of the queue of the writer thread of each logger, 0 to write
+  /// entries synchronously during the vision step
+  int logQueueSize;
+
+  /// Behavior of the loggers when their queue is full: "dropNewest" or "block"
+  std::string logDropPolicy;
+
+  /// Memory allowed for the compressed images of the moving ball and game
+  /// loggers [MB], 0 to write their images directly
+  int logMemoryBudget;
+
+  /// Compression of the images kept in memory: "jpg" or "png"
+  std::string logCompression;
+
+  /// Quality of the images kept in memory when using jpg [0-100]
+  int logJpegQuality;
+
+  /// Format of the log sessions: "video" (video and protobuf files) or
+  /// "container" (single log container including low-level histories)
+  std::string logFormat;
+
   /// If activated: write ball position and speed in self referntial at each
   /// vision step
   bool writeBallStatus;
@@ -158,6 +182,7 @@ public:
   void readPipeline();
   void getUpdatedCameraStateFromPipeline();
   void loggingStep();
+  void loggingStep(const Utils::ImageLogger::Entry& entry);
   void updateBallInformations();
   void updateRobotInformations();
 
@@ -211,6 +236,12 @@ public:
   std::thread* _runThread;
   bool _doRun;
 
+  /**
+   * Thread running the late stages (localisation, logging, tagging) when
+   * pipelineDepth is above 1
+   */
+  std::thread* _lateStagesThread;
+
   // BALL
   /// Ball position filter
   Localisation::BallStackFilter* ballStackFilter;
@@ -234,6 +265,91 @@ public:
   bool clearRememberObservations;
 
 private:
+  /**
+   * Features detected by a single provider, in image basis
+   */
+  struct FeaturesInImg
+  {
+    std::string provider_name;
+    std::vector<cv::Point2f> balls;
+    std::map<hl_monitoring::Field::POIType, std::vector<cv::Point2f>> pois;
+    std::vector<cv::Point2f> robots;
+  };
+
+  /**
+   * Everything the late stages need to know about a frame processed by the
+   * pipeline, allowing the pipeline to start processing the next frame
+   */
+  struct PipelineFrame
+  {
+    /// Copy of the camera state at the acquisition of the frame
+    Utils::CameraState cs;
+    /// Timestamp of the pipeline for this frame
+    rhoban_utils::TimeStamp pipeline_ts;
+    /// Copy of the image provided by the 'human' filter
+    cv::Mat log_img;
+    std::vector<FeaturesInImg> features;
+  };
+
+  /// Run Application::step and handle camera failures
+  /// Return 0 on success, otherwise the time to wait before next attempt [ms]
+  int runPipelineStep();
+
+  /// Publish the latencies of the stages and filters of the pipeline to RhIO
+  /// at most once per latenciesPublicationPeriod, called by the thread
+  /// stepping the pipeline
+  void publishLatencies();
+
+  /// Minimal duration between two publications of the latencies [ms]
+  static constexpr double latenciesPublicationPeriod = 1000;
+  rhoban_utils::TimeStamp lastLatenciesPublication;
+
+  /// Update and publish the special images if they are displayed or streamed
+  void updateImageHandlers();
+
+  /// Publish the allocations of the last step of the pipeline and, when
+  /// benchmark is enabled, the time spent in each filter in 'Vision/stepTimes'
+  /// since filters run by worker threads do not appear in the benchmark tree
+  void publishPipelineStats();
+
+  /// Replace the camera state used by Robocup and its filters
+  void updateCameraState(Utils::CameraState* new_cs);
+
+  /// Extract the features from all the providers of the pipeline
+  void collectFeatures(std::vector<FeaturesInImg>* features);
+
+  /// Convert features to world basis using 'cs' and store them
+  void importFeatures(const std::vector<FeaturesInImg>& features);
+
+  /// Run the pipeline and push the result to the late stages, waiting if
+  /// pipelineDepth frames are already in progress
+  void stepEarlyStages();
+
+  /// Main loop of the late stages thread
+  void runLateStages();
+
+  /// Localisation, logging and tagging for a frame extracted from the pipeline
+  void stepLateStages(std::unique_ptr<PipelineFrame> frame);
+
+  /**
+   * Number of frames which can be in progress simultaneously:
+   * - 1: pipeline and localisation are run sequentially (default)
+   * - 2+: the pipeline processes frame N+1 while the localisation and logging
+   *       are run on frame N, at most 'pipelineDepth - 1' frames are waiting
+   *       for the late stages
+   * Note: in pipelined mode, 'TaggedImg' is drawn on the latest image of the
+   * pipeline which can be one frame ahead of the localisation
+   */
+  int pipelineDepth;
+
+  /// Frames processed by the pipeline and waiting for the late stages
+  std::deque<std::unique_ptr<PipelineFrame>> pendingFrames;
+  std::mutex pendingFramesMutex;
+  std::condition_variable pendingFramesCond;
+
+  /// The frame currently used by the late stages, 'cs' points to its camera state
+  std::unique_ptr<PipelineFrame> currentFrame;
+
   /**
    * Detected field features in "world" basis
    */
@@ -196,7 +196,7 @@ void CameraState::updateInternalModel(const rhoban_utils::TimeStamp& ts)
     double scheduler_ts = getSchedulerTS(ts);
     ModelService* modelService = _moveScheduler->getServices()->model;
     ViveService* vive = _moveScheduler->getServices()->vive;
-    DecisionService* decision = _moveScheduler->getServices()->decision;
+    auto decision = _moveScheduler->getServices()->decision->getSnapshot();
     RefereeService* referee = _moveScheduler->getServices()->referee;
 
     source_id.Clear();
@@ -252,7 +252,7 @@ void CameraState::updateInternalModel(const rhoban_utils::TimeStamp& ts)
     }
     else if (decision->isFieldQualityGood)
     {
-      LocalisationService* loc = _moveScheduler->getServices()->localisation;
+      auto loc = _moveScheduler->getServices()->localisation->getSnapshot();
       camera_from_field = worldToCamera * loc->world_from_field;
       has_camera_field_transform = true;
     }
@@ -445,6 +445,37 @@ rhoban_geometry::Ray CameraState::getRayInWorldFromPixel(const cv::Point2f& img_
   return Ray(cameraPosInWorld, viewVectorInWorld);
 }
 
+int CameraState::getTopGroundRow(int nb_cols) const
+{
+  cv::Size size = getImgSize();
+  int top_row = size.height;
+  for (int col_idx = 0; col_idx < nb_cols; col_idx++)
+  {
+    float col = 0;
+    if (nb_cols > 1)
+    {
+      col = col_idx * (size.width - 1) / (float)(nb_cols - 1);
+    }
+    // Binary search on the first row looking downward: [min_row, max_row]
+    int min_row = 0;
+    int max_row = size.height;
+    while (min_row < max_row)
+    {
+      int row = (min_row + max_row) / 2;
+      if (getRayInWorldFromPixel(cv::Point2f(col, row)).dir.z() < 0)
+      {
+        max_row = row;
+      }
+      else
+      {
+        min_row = row + 1;
+      }
+    }
+    top_row = std::min(top_row, min_row);
+  }
+  return top_row;
+}
+
 Eigen::Vector3d CameraState::posInWorldFromPixel(const cv::Point2f& pos, double ground_height) const
 {
   Ray viewRay = getRayInWorldFromPixel(pos);
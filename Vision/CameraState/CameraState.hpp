@@ -141,6 +141,17 @@ public:
    */
   double computeBallRadiusFromPixel(const cv::Point2f& pos) const;
 
+  /**
+   * Return the smallest row of the image at which the ground is visible,
+   * evaluated on nb_cols columns regularly spread over the image width.
+   *
+   * On each of these columns, pixels are considered to see the ground once
+   * the associated ray points downward, assuming that this property does not
+   * change further down in the image. Returns the height of the image if
+   * the ground is not visible at all.
+   */
+  int getTopGroundRow(int nb_cols = 5) const;
+
   /// Distance to ground [m]
   double getHeight();
 
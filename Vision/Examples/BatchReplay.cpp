@@ -0,0 +1,45 @@
+#include "Application/BatchReplay.hpp"
+
+#include <tclap/CmdLine.h>
+
+#include <iostream>
+
+using namespace Vision;
+
+int main(int argc, char** argv)
+{
+  TCLAP::CmdLine cmd("Runs a vision pipeline over several logs without display", ' ', "0.1");
+  TCLAP::ValueArg<std::string> pipeline("p", "pipeline", "Json description of the pipeline, '$LOG_DIR' is replaced by "
+                                                         "the directory of each log",
+                                        true, "", "pipeline", cmd);
+  TCLAP::ValueArg<int> threads("t", "threads", "Number of logs processed simultaneously (0: hardware threads)", false,
+                               0, "threads", cmd);
+  TCLAP::ValueArg<int> maxFrames("m", "max-frames", "Maximal number of frames per log (0: no limit)", false, 0,
+                                 "max-frames", cmd);
+  TCLAP::ValueArg<std::string> jsonPath("j", "json", "Output file for detections and timings", false,
+                                        "batch_replay.json", "json", cmd);
+  TCLAP::ValueArg<std::string> csvPath("c", "csv", "Output file for timings of the filters", false, "", "csv", cmd);
+  TCLAP::UnlabeledMultiArg<std::string> logs("logs", "Directories of the logs", true, "logs", cmd);
+  cmd.parse(argc, argv);
+
+  Application::BatchReplay batch(pipeline.getValue(), threads.getValue(), maxFrames.getValue());
+  batch.run(logs.getValue());
+
+  int nb_failures = 0;
+  for (const Application::BatchReplay::LogResult& result : batch.getResults())
+  {
+    std::cout << result.log_dir << ": " << result.nb_frames << " frames";
+    if (result.error != "")
+    {
+      std::cout << ", failed: " << result.error;
+      nb_failures++;
+    }
+    std::cout << std::endl;
+  }
+  batch.writeJson(jsonPath.getValue());
+  if (csvPath.getValue() != "")
+  {
+    batch.writeCsv(csvPath.getValue());
+  }
+  return nb_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "Utils/ColorLUT.hpp"
+#include "Utils/YCrCb.hpp"
+
+#include <opencv2/highgui/highgui.hpp>
+#include <tclap/CmdLine.h>
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace Vision;
+
+/// Return the paths of the images contained in 'dir'
+std::vector<std::string> listImages(const std::string& dir)
+{
+  std::vector<std::string> paths;
+  DIR* dir_handle = opendir(dir.c_str());
+  if (dir_handle == nullptr)
+  {
+    throw std::runtime_error("Failed to open directory '" + dir + "'");
+  }
+  struct dirent* entry;
+  while ((entry = readdir(dir_handle)) != nullptr)
+  {
+    std::string file_name = entry->d_name;
+    size_t dot = file_name.rfind('.');
+    std::string extension = dot == std::string::npos ? "" : file_name.substr(dot);
+    if (extension == ".png" || extension == ".jpg" || extension == ".jpeg")
+    {
+      paths.push_back(dir + "/" + file_name);
+    }
+  }
+  closedir(dir_handle);
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+/// Convert a BGR image to YCrCb with the same conversion as the filters
+cv::Mat toYCrCb(const cv::Mat& bgr)
+{
+  cv::Mat yuv(bgr.size(), CV_8UC3);
+  std::vector<uint8_t> planes(3 * bgr.cols);
+  uint8_t* y_row = planes.data();
+  uint8_t* u_row = y_row + bgr.cols;
+  uint8_t* v_row = u_row + bgr.cols;
+  for (int row = 0; row < bgr.rows; row++)
+  {
+    Utils::YCrCb::convertBGRRow(bgr.ptr<uint8_t>(row), bgr.cols, y_row, u_row, v_row);
+    Utils::YCrCb::interleaveRow(y_row, u_row, v_row, bgr.cols, yuv.ptr<uint8_t>(row));
+  }
+  return yuv;
+}
+
+int main(int argc, char** argv)
+{
+  TCLAP::CmdLine cmd("Builds a color lookup table from directories of labelled patches", ' ', "0.1");
+  TCLAP::ValueArg<std::string> output("o", "output", "Path of the lookup table", false, "colors.lut", "output", cmd);
+  TCLAP::ValueArg<int> bits("b", "bits", "Number of bits used for each channel", false, 6, "bits", cmd);
+  TCLAP::ValueArg<int> minSamples("m", "min-samples", "Minimal number of samples to label a cell", false, 1,
+                                  "min-samples", cmd);
+  TCLAP::ValueArg<int> grow("g", "grow", "Number of iterations growing labelled regions", false, 0, "grow", cmd);
+  TCLAP::UnlabeledMultiArg<std::string> classes("classes", "Patches of each class as 'name:directory', patches are "
+                                                           "BGR images",
+                                                true, "classes", cmd);
+  cmd.parse(argc, argv);
+
+  std::vector<std::string> class_names, class_dirs;
+  for (const std::string& arg : classes.getValue())
+  {
+    size_t sep = arg.find(':');
+    if (sep == std::string::npos)
+    {
+      std::cerr << "Invalid class '" << arg << "', expecting 'name:directory'" << std::endl;
+      return 1;
+    }
+    class_names.push_back(arg.substr(0, sep));
+    class_dirs.push_back(arg.substr(sep + 1));
+  }
+
+  Utils::ColorLUT lut(bits.getValue(), class_names);
+  for (size_t idx = 0; idx < class_names.size(); idx++)
+  {
+    std::vector<std::string> paths = listImages(class_dirs[idx]);
+    for (const std::string& path : paths)
+    {
+      cv::Mat patch = cv::imread(path, cv::IMREAD_COLOR);
+      if (patch.empty())
+      {
+        std::cerr << "Failed to read '" << path << "'" << std::endl;
+        continue;
+      }
+      lut.addSamples(toYCrCb(patch), idx + 1);
+    }
+    std::cout << class_names[idx] << ": " << paths.size() << " patches" << std::endl;
+  }
+  lut.build(minSamples.getValue());
+  lut.grow(grow.getValue());
+  lut.save(output.getValue());
+  return 0;
+}
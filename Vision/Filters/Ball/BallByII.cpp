@@ -10,7 +10,7 @@
 #include "Utils/RotatedRectUtils.hpp"
 #include "CameraState/CameraState.hpp"
 
-#include <set>
+#include <algorithm>
 
 using rhoban_utils::Benchmark;
 
@@ -46,6 +46,8 @@ void BallByII::setParameters()
   maxOverlapRatio = ParamFloat(0.2, 0.0, 1.0);
   inputSizeFactor = ParamFloat(1.0, 0.01, 10.0);
   outputSizeFactor = ParamFloat(1.0, 0.01, 10.0);
+  useScoringEngine = ParamInt(1, 0, 1);
+  nmsCellSize = ParamInt(32, 1, 512);
 
   params()->define<ParamFloat>("boundaryFactor", &boundaryFactor);
   params()->define<ParamFloat>("maxBoundaryThickness", &maxBoundaryThickness);
@@ -60,6 +62,8 @@ void BallByII::setParameters()
   params()->define<ParamFloat>("maxOverlapRatio", &maxOverlapRatio);
   params()->define<ParamFloat>("inputSizeFactor", &inputSizeFactor);
   params()->define<ParamFloat>("outputSizeFactor", &outputSizeFactor);
+  params()->define<ParamInt>("useScoringEngine", &useScoringEngine);
+  params()->define<ParamInt>("nmsCellSize", &nmsCellSize);
 }
 
 void BallByII::process()
@@ -95,45 +99,97 @@ void BallByII::process()
   cv::Mat scores;
   if (tagLevel > 0)
   {
-    scores = cv::Mat(rows, cols, CV_32SC1, cv::Scalar(0.0));
+    scores = getScratch(cv::Size(cols, rows), CV_32SC1);
+    scores.setTo(0);
   }
+  BallScoringEngine::Config config = getScoringConfig();
+  std::vector<int> xCenters;
+  nms.reset(cv::Size(cols, rows), nmsCellSize, maxRois, maxOverlapRatio);
+  // Candidates above the horizon have no expected radius, their score is 0
+  int groundStartRow = getGroundStartRow(rows);
   for (int y = 0; y * decimationRate < rows; y++)
   {
+    // Centers of the cells are on the same line for the whole row
+    int row_start_y = y * decimationRate;
+    int row_end_y = std::min((y + 1) * (int)decimationRate, rows - 1);
+    int row_center_y = (row_start_y + row_end_y) / 2;
+    if (row_center_y < groundStartRow)
+    {
+      continue;
+    }
+    if (useScoringEngine)
+    {
+      xCenters.clear();
+      for (int x = 0; x * decimationRate < cols; x++)
+      {
+        int start_x = x * decimationRate;
+        int end_x = std::min((x + 1) * (int)decimationRate, cols - 1);
+        xCenters.push_back((start_x + end_x) / 2);
+      }
+      scoringEngine.scoreRow(row_center_y, xCenters, radiusImg, yImg, greenImg, config);
+    }
+    const float* radiusRow = radiusImg.ptr<float>(row_center_y);
     for (int x = 0; x * decimationRate < cols; x++)
     {
       // Computing limits of the current area
       int start_x = x * decimationRate;
-      int start_y = y * decimationRate;
+      int start_y = row_start_y;
       int end_x = (x + 1) * decimationRate;
-      int end_y = (y + 1) * decimationRate;
+      int end_y = row_end_y;
       if (end_x >= cols)
         end_x = cols - 1;
-      if (end_y >= rows)
-        end_y = rows - 1;
 
       // Getting the middle point
       int center_x = (start_x + end_x) / 2;
-      int center_y = (start_y + end_y) / 2;
+      int center_y = row_center_y;
 
-      // Checking radius before computing ROIs (if radius < 1 -> errors)
-      float radius = radiusImg.at<float>(center_y, center_x) * inputSizeFactor;
-      if (radius <= minRadius)
+      BallScoringEngine::Status status;
+      float radius;
+      double score = 0;
+      cv::Rect_<float> outputPatch;
+      if (useScoringEngine)
       {
-        if (tagLevel > 0)
+        status = scoringEngine.getStatus(x);
+        radius = scoringEngine.getRadius(x);
+        score = scoringEngine.getScore(x);
+        outputPatch = scoringEngine.getOutputPatch(x);
+      }
+      else
+      {
+        status = BallScoringEngine::Valid;
+        // Checking radius before computing ROIs (if radius < 1 -> errors)
+        radius = radiusRow[center_x] * inputSizeFactor;
+        if (radius <= minRadius)
         {
-          fillScore(scores, 0, start_x, end_x, start_y, end_y);
+          status = BallScoringEngine::SmallRadius;
+        }
+        else
+        {
+          // Computing boundary patch
+          cv::Rect_<float> boundaryPatch = getBoundaryPatch(center_x, center_y, radius);
+          outputPatch = getOutputPatch(center_x, center_y, radius);
+          bool rois_inside_img = Utils::isContained(boundaryPatch, size) && Utils::isContained(outputPatch, size);
+          if (!rois_inside_img)
+          {
+            status = BallScoringEngine::OutOfImage;
+          }
+          else
+          {
+            try
+            {
+              score = getCandidateScore(center_x, center_y, radius, yImg, greenImg);
+            }
+            catch (const std::runtime_error& exc)
+            {
+              status = BallScoringEngine::EmptyPatch;
+            }
+          }
         }
-        continue;
       }
 
-      // Computing boundary patch
-      cv::Rect_<float> boundaryPatch = getBoundaryPatch(center_x, center_y, radius);
-      cv::Rect_<float> outputPatch = getOutputPatch(center_x, center_y, radius);
-      bool rois_inside_img = Utils::isContained(boundaryPatch, size) && Utils::isContained(outputPatch, size);
-
       // If area is not entirely inside the image or expected radius is too small:
       // - Skip ROI and use a '0' score
-      if (!rois_inside_img)
+      if (status == BallScoringEngine::SmallRadius || status == BallScoringEngine::OutOfImage)
       {
         if (tagLevel > 0)
         {
@@ -141,13 +197,7 @@ void BallByII::process()
         }
         continue;
       }
-
-      double score = 0;
-      try
-      {
-        score = getCandidateScore(center_x, center_y, radius, yImg, greenImg);
-      }
-      catch (const std::runtime_error& exc)
+      if (status == BallScoringEngine::EmptyPatch)
       {
         logger.error("%s: Failed to get score for patch at: %d,%d with radius %f: ignoring candidate",
                      DEBUG_INFO.c_str(), center_x, center_y, radius);
@@ -175,81 +225,11 @@ void BallByII::process()
         continue;
       }
 
-      // Establishing:
-      // - List of dominated ROIs
-      // - Worst score
-      // If current candidate is dominated, then stop the process and ignore current candidate
-      std::set<size_t> dominated_rois;
-      bool dominated = false;
-      double worstScore = score;
-      int worstId = -1;
-      const cv::Rect& candidatePatch = outputPatch;
-      for (size_t id = 0; id < tmpRois.size(); id++)
-      {
-        double roiScore = tmpRois[id].first;
-        const cv::Rect& roi = tmpRois[id].second;
-        // If there is an overlap with 'id'
-        if (Utils::computeOverlapRatio(roi, candidatePatch) > maxOverlapRatio)
-        {
-          // If new region is better, then it dominates 'id'
-          if (roiScore < score)
-          {
-            dominated_rois.insert(id);
-          }
-          // If new region is not better, simply stop the process and ignore the region
-          else
-          {
-            dominated = true;
-            break;
-          }
-        }
-        // If score is lower than previously met, update
-        if (worstScore > roiScore)
-        {
-          worstScore = roiScore;
-          worstId = id;
-        }
-      }
-      // If roi is dominated, jump to next ROI
-      if (dominated)
-      {
-      }
-      // No areas directly dominated
-      else if (dominated_rois.size() == 0)
-      {
-        // If there is enough space remaining, push element
-        if ((int)tmpRois.size() < maxRois)
-        {
-          tmpRois.push_back({ score, candidatePatch });
-        }
-        // If there is not enough space: replace worst ROI (if patch is better)
-        else if (worstId != -1)
-        {
-          tmpRois[worstId] = { score, candidatePatch };
-        }
-      }
-      // If one area is dominated, replace it
-      else if (dominated_rois.size() == 1)
-      {
-        tmpRois[*(dominated_rois.begin())] = { score, candidatePatch };
-      }
-      // If more than one area is dominated, remove all dominated areas and add current one
-      else
-      {
-        std::vector<std::pair<double, cv::Rect>> oldRois = tmpRois;
-        tmpRois.clear();
-        for (size_t roi_idx = 0; roi_idx < oldRois.size(); roi_idx++)
-        {
-          bool discard = dominated_rois.count(roi_idx) == 1;
-          if (!discard)
-          {
-            tmpRois.push_back(oldRois[roi_idx]);
-          }
-        }
-        tmpRois.push_back({ score, candidatePatch });
-      }
+      // Candidate is kept or not depending on its overlap with other ROIs
+      nms.insert(score, outputPatch);
     }
   }
+  tmpRois = nms.getROIs();
 
   Benchmark::close("computing decimated scores");
 
@@ -311,20 +291,21 @@ void BallByII::process()
   }
 
   Benchmark::open("getHeatMap");
+  cv::Mat& dst = allocateImg(cv::Size(cols, rows), CV_8UC3);
   if (tagLevel > 0)
   {
-    img() = getHeatMap(scores, imgMinScore, imgMaxScore);
+    getHeatMap(scores, imgMinScore, imgMaxScore, dst);
   }
   else
   {
-    img() = cv::Mat(rows, cols, CV_8UC3, cv::Scalar(0, 0, 0));
+    dst.setTo(cv::Scalar(0, 0, 0));
   }
   Benchmark::close("getHeatMap");
 }
 
-cv::Mat BallByII::getHeatMap(const cv::Mat& scores, double imgMinScore, double imgMaxScore) const
+void BallByII::getHeatMap(const cv::Mat& scores, double imgMinScore, double imgMaxScore, cv::Mat& result) const
 {
-  cv::Mat result(rows, cols, CV_8UC3, cv::Scalar(0, 0, 0));
+  result.setTo(cv::Scalar(0, 0, 0));
   double diffScore = imgMaxScore - imgMinScore;
   if (diffScore > 0)
   {
@@ -338,76 +319,72 @@ cv::Mat BallByII::getHeatMap(const cv::Mat& scores, double imgMinScore, double i
     // Going back to color
     for (int y = 0; y < rows; y++)
     {
+      const int* scoresRow = scores.ptr<int>(y);
+      cv::Vec3b* resultRow = result.ptr<cv::Vec3b>(y);
       for (int x = 0; x < cols; x++)
       {
-        int score = scores.at<int>(y, x);
+        int score = scoresRow[x];
         if (score > 0)
         {
           int intensity = (int)(score * factorAbove);
-          result.at<cv::Vec3b>(y, x) = cv::Vec3b(0, 0, intensity);
+          resultRow[x] = cv::Vec3b(0, 0, intensity);
         }
         else
         {
           int intensity = (int)(score * factorBelow);
-          result.at<cv::Vec3b>(y, x) = cv::Vec3b(intensity, 0, 0);
+          resultRow[x] = cv::Vec3b(intensity, 0, 0);
         }
       }
     }
   }
-  return result;
+}
+
+BallScoringEngine::Config BallByII::getScoringConfig()
+{
+  BallScoringEngine::Config config;
+  config.boundaryFactor = boundaryFactor;
+  config.maxBoundaryThickness = maxBoundaryThickness;
+  config.minRadius = minRadius;
+  config.yWeight = yWeight;
+  config.greenWeight = greenWeight;
+  config.inputSizeFactor = inputSizeFactor;
+  config.outputSizeFactor = outputSizeFactor;
+  return config;
 }
 
 double BallByII::getBoundaryHalfWidth(float radius)
 {
-  return std::min(radius * boundaryFactor, radius + maxBoundaryThickness);
+  return BallScoringEngine::getBoundaryHalfWidth(radius, getScoringConfig());
 }
 
 cv::Rect_<float> BallByII::getInnerPatch(int x, int y, float radius)
 {
-  // Creating inner patch
-  cv::Point2f center(x, y);
-  cv::Point2f halfSize(radius, radius);
-  return cv::Rect_<float>(center - halfSize, center + halfSize);
+  return BallScoringEngine::getInnerPatch(x, y, radius);
 }
 
 cv::Rect_<float> BallByII::getInnerAbovePatch(int x, int y, float radius)
 {
-  cv::Point2f center(x, y);
-  cv::Point2f halfSize(radius, radius);
-  return cv::Rect_<float>(center - halfSize, center + cv::Point2f(radius, 0));
+  return BallScoringEngine::getInnerAbovePatch(x, y, radius);
 }
 
 cv::Rect_<float> BallByII::getInnerBelowPatch(int x, int y, float radius)
 {
-  cv::Point2f center(x, y);
-  cv::Point2f halfSize(radius, radius);
-  return cv::Rect_<float>(center - cv::Point2f(radius, 0), center + halfSize);
+  return BallScoringEngine::getInnerBelowPatch(x, y, radius);
 }
 
 cv::Rect_<float> BallByII::getBoundaryPatch(int x, int y, float radius)
 {
-  // Creating boundary patch
-  cv::Point2f center(x, y);
-  double halfWidth = getBoundaryHalfWidth(radius);
-  cv::Point2f halfSize(halfWidth, halfWidth);
-  return cv::Rect_<float>(center - halfSize, center + halfSize);
+  return BallScoringEngine::getBoundaryPatch(x, y, radius, getScoringConfig());
 }
 
 cv::Rect_<float> BallByII::getOutputPatch(int x, int y, float radius)
 {
-  // Creating boundary patch
-  cv::Point2f center(x, y);
-  double halfWidth = radius * outputSizeFactor;
-  cv::Point2f halfSize(halfWidth, halfWidth);
-  return cv::Rect_<float>(center - halfSize, center + halfSize);
+  return BallScoringEngine::getOutputPatch(x, y, radius, getScoringConfig());
 }
 
 cv::Rect_<float> BallByII::getBoundaryAbovePatch(int x, int y, float radius)
 {
-  double halfWidth = getBoundaryHalfWidth(radius);
-  cv::Point2f tl(x - radius, y - halfWidth);
-  cv::Point2f fullSize(2 * radius, halfWidth - radius);
-  return cv::Rect_<float>(tl, tl + fullSize);
+  return BallScoringEngine::getBoundaryAbovePatch(x, y, radius, getScoringConfig());
 }
 
 double BallByII::getCandidateScore(int center_x, int center_y, double radius, const cv::Mat& yImg,
@@ -452,10 +429,8 @@ void BallByII::fillScore(cv::Mat& img, int score, int start_x, int end_x, int st
 {
   for (int y = start_y; y < end_y; y++)
   {
-    for (int x = start_x; x < end_x; x++)
-    {
-      img.at<int>(y, x) = score;
-    }
+    int* row = img.ptr<int>(y);
+    std::fill(row + start_x, row + end_x, score);
   }
 }
 
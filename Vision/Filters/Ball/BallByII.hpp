@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Filters/Filter.hpp"
+#include "Filters/Ball/BallScoringEngine.hpp"
+#include "Utils/ROITools.hpp"
 
 namespace Vision
 {
@@ -30,9 +32,13 @@ protected:
 
   virtual void setParameters() override;
 
-  cv::Mat getHeatMap(const cv::Mat& scores, double minScore, double maxScore) const;
+  /// Draw the scores in 'result' which has to be a CV_8UC3 image of the size of scores
+  void getHeatMap(const cv::Mat& scores, double minScore, double maxScore, cv::Mat& result) const;
 
 private:
+  /// Build the configuration of the scoring engine from current parameters
+  BallScoringEngine::Config getScoringConfig();
+
   /// Return the half width corresponding to a ball of the given radius
   double getBoundaryHalfWidth(float radius);
   /// Return the patch associated to the inner part of the ball at the given point
@@ -98,6 +104,11 @@ private:
    */
   ParamFloat maxOverlapRatio;
 
+  /**
+   * Size of the cells used to find overlapping ROIs [px], should be close to the size of the ROIs
+   */
+  ParamInt nmsCellSize;
+
   /**
    * Multiplies the input from radius image to adjust expected size
    */
@@ -107,6 +118,16 @@ private:
    * Adjust scale of the region of interest in output
    */
   ParamFloat outputSizeFactor;
+
+  /// 0: Candidates are scored one by one (reference implementation)
+  /// 1: Candidates are scored row by row using scoringEngine
+  ParamInt useScoringEngine;
+
+  /// Reused between frames to avoid reallocation of its buffers
+  BallScoringEngine scoringEngine;
+
+  /// Selection of the ROIs, reused between frames to avoid reallocation of its grid
+  Utils::ROIGridNMS nms;
 };
 }  // namespace Filters
 }  // namespace Vision
@@ -0,0 +1,171 @@
+#include "Filters/Ball/BallScoringEngine.hpp"
+
+#include "Utils/ROITools.hpp"
+
+#include <algorithm>
+
+namespace Vision
+{
+namespace Filters
+{
+double BallScoringEngine::getBoundaryHalfWidth(float radius, const Config& config)
+{
+  return std::min(radius * config.boundaryFactor, radius + config.maxBoundaryThickness);
+}
+
+cv::Rect_<float> BallScoringEngine::getInnerPatch(int x, int y, float radius)
+{
+  // Creating inner patch
+  cv::Point2f center(x, y);
+  cv::Point2f halfSize(radius, radius);
+  return cv::Rect_<float>(center - halfSize, center + halfSize);
+}
+
+cv::Rect_<float> BallScoringEngine::getInnerAbovePatch(int x, int y, float radius)
+{
+  cv::Point2f center(x, y);
+  cv::Point2f halfSize(radius, radius);
+  return cv::Rect_<float>(center - halfSize, center + cv::Point2f(radius, 0));
+}
+
+cv::Rect_<float> BallScoringEngine::getInnerBelowPatch(int x, int y, float radius)
+{
+  cv::Point2f center(x, y);
+  cv::Point2f halfSize(radius, radius);
+  return cv::Rect_<float>(center - cv::Point2f(radius, 0), center + halfSize);
+}
+
+cv::Rect_<float> BallScoringEngine::getBoundaryPatch(int x, int y, float radius, const Config& config)
+{
+  // Creating boundary patch
+  cv::Point2f center(x, y);
+  double halfWidth = getBoundaryHalfWidth(radius, config);
+  cv::Point2f halfSize(halfWidth, halfWidth);
+  return cv::Rect_<float>(center - halfSize, center + halfSize);
+}
+
+cv::Rect_<float> BallScoringEngine::getBoundaryAbovePatch(int x, int y, float radius, const Config& config)
+{
+  double halfWidth = getBoundaryHalfWidth(radius, config);
+  cv::Point2f tl(x - radius, y - halfWidth);
+  cv::Point2f fullSize(2 * radius, halfWidth - radius);
+  return cv::Rect_<float>(tl, tl + fullSize);
+}
+
+cv::Rect_<float> BallScoringEngine::getOutputPatch(int x, int y, float radius, const Config& config)
+{
+  // Creating boundary patch
+  cv::Point2f center(x, y);
+  double halfWidth = radius * config.outputSizeFactor;
+  cv::Point2f halfSize(halfWidth, halfWidth);
+  return cv::Rect_<float>(center - halfSize, center + halfSize);
+}
+
+void BallScoringEngine::scoreRow(int centerY, const std::vector<int>& xCenters, const cv::Mat& radiusImg,
+                                 const cv::Mat& yImg, const cv::Mat& greenImg, const Config& config)
+{
+  size_t nbCandidates = xCenters.size();
+  status.assign(nbCandidates, Valid);
+  radiuses.resize(nbCandidates);
+  scores.assign(nbCandidates, 0);
+  outputPatches.resize(nbCandidates);
+  batchCandidates.clear();
+  for (int type = 0; type < NbPatchTypes; type++)
+  {
+    batches[type].clear();
+    batches[type].reserve(nbCandidates);
+  }
+
+  const cv::Size& size = yImg.size();
+  const float* radiusRow = radiusImg.ptr<float>(centerY);
+
+  // Computing the geometry of all the patches
+  for (size_t idx = 0; idx < nbCandidates; idx++)
+  {
+    int centerX = xCenters[idx];
+    float radius = radiusRow[centerX] * config.inputSizeFactor;
+    radiuses[idx] = radius;
+    if (radius <= config.minRadius)
+    {
+      status[idx] = SmallRadius;
+      continue;
+    }
+    cv::Rect_<float> boundaryPatch = getBoundaryPatch(centerX, centerY, radius, config);
+    outputPatches[idx] = getOutputPatch(centerX, centerY, radius, config);
+    if (!Utils::isContained(boundaryPatch, size) || !Utils::isContained(outputPatches[idx], size))
+    {
+      status[idx] = OutOfImage;
+      continue;
+    }
+    size_t batchIdx = batchCandidates.size();
+    batches[Boundary].push(boundaryPatch, size);
+    batches[Inner].push(getInnerPatch(centerX, centerY, radius), size);
+    batches[InnerAbove].push(getInnerAbovePatch(centerX, centerY, radius), size);
+    batches[InnerBelow].push(getInnerBelowPatch(centerX, centerY, radius), size);
+    batches[BoundaryAbove].push(getBoundaryAbovePatch(centerX, centerY, radius, config), size);
+    for (int type = 0; type < NbPatchTypes; type++)
+    {
+      if (batches[type].getArea(batchIdx) == 0)
+      {
+        status[idx] = EmptyPatch;
+      }
+    }
+    batchCandidates.push_back(idx);
+  }
+
+  // Computing the sums of all patches at once
+  for (int type : { Boundary, InnerAbove, InnerBelow, BoundaryAbove })
+  {
+    batches[type].computeSums(yImg, &(ySums[type]));
+  }
+  for (int type : { Boundary, Inner })
+  {
+    batches[type].computeSums(greenImg, &(greenSums[type]));
+  }
+
+  // Combining the densities, see BallByII for the details of the score
+  for (size_t batchIdx = 0; batchIdx < batchCandidates.size(); batchIdx++)
+  {
+    size_t idx = batchCandidates[batchIdx];
+    if (status[idx] != Valid)
+    {
+      continue;
+    }
+    double y_ia = ySums[InnerAbove][batchIdx] / (double)batches[InnerAbove].getArea(batchIdx);
+    double y_ib = ySums[InnerBelow][batchIdx] / (double)batches[InnerBelow].getArea(batchIdx);
+    double y_b = ySums[Boundary][batchIdx] / (double)batches[Boundary].getArea(batchIdx);
+    double y_ub = ySums[BoundaryAbove][batchIdx] / (double)batches[BoundaryAbove].getArea(batchIdx);
+    double y_score_far = 3 * y_ia - y_ub - y_ib - y_b;
+    double y_score_close = y_ia + y_ib - 2 * y_b;
+    double y_score = std::max(y_score_far, y_score_close);
+
+    double green_b = greenSums[Boundary][batchIdx] / (double)batches[Boundary].getArea(batchIdx);
+    double green_i = greenSums[Inner][batchIdx] / (double)batches[Inner].getArea(batchIdx);
+    double green_score = green_b - green_i;
+
+    scores[idx] = (config.yWeight * y_score + config.greenWeight * green_score) / (config.yWeight + config.greenWeight);
+  }
+}
+
+BallScoringEngine::Status BallScoringEngine::getStatus(size_t idx) const
+{
+  return status[idx];
+}
+
+float BallScoringEngine::getRadius(size_t idx) const
+{
+  return radiuses[idx];
+}
+
+double BallScoringEngine::getScore(size_t idx) const
+{
+  return scores[idx];
+}
+
+const cv::Rect_<float>& BallScoringEngine::getOutputPatch(size_t idx) const
+{
+  return outputPatches[idx];
+}
+
+}  // namespace Filters
+}  // namespace Vision
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Utils/PatchTools.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+
+namespace Vision
+{
+namespace Filters
+{
+/// Computes the scores used by BallByII for a whole row of candidates at once
+///
+/// The geometry of the patches is computed for all the candidates of the row
+/// from the radius image, then the sums over the integral images are computed
+/// for each kind of patch in a single pass (see Utils::PatchBatch). Scores are
+/// identical to the ones obtained by evaluating the candidates one by one.
+class BallScoringEngine
+{
+public:
+  struct Config
+  {
+    /// Usual size ratio between inner side and boundary side
+    float boundaryFactor;
+    /// The maximal thickness of the border area
+    float maxBoundaryThickness;
+    /// Candidates with a radius below this value are not scored
+    float minRadius;
+    /// The weight of the 'Y' component on a patch score
+    float yWeight;
+    /// The weight of green inside a patch score
+    float greenWeight;
+    /// Multiplies the input from radius image to adjust expected size
+    float inputSizeFactor;
+    /// Adjust scale of the region of interest in output
+    float outputSizeFactor;
+  };
+
+  enum Status
+  {
+    /// Candidate has been scored
+    Valid,
+    /// Expected radius is below minRadius
+    SmallRadius,
+    /// Boundary or output patch is not entirely inside the image
+    OutOfImage,
+    /// One of the patches has an empty area
+    EmptyPatch
+  };
+
+  /// Return the half width corresponding to a ball of the given radius
+  static double getBoundaryHalfWidth(float radius, const Config& config);
+  /// Return the patch associated to the inner part of the ball at the given point
+  static cv::Rect_<float> getInnerPatch(int x, int y, float radius);
+  /// Return the patch associated to the inner upper part of the ball at the given point
+  static cv::Rect_<float> getInnerAbovePatch(int x, int y, float radius);
+  /// Return the patch associated to the inner bottom part of the ball at the given point
+  static cv::Rect_<float> getInnerBelowPatch(int x, int y, float radius);
+  /// Return the patch associated to the boundary part of the ball at the given point
+  static cv::Rect_<float> getBoundaryPatch(int x, int y, float radius, const Config& config);
+  /// Return the patch associated to the upper boundary part of the ball at the given point
+  static cv::Rect_<float> getBoundaryAbovePatch(int x, int y, float radius, const Config& config);
+  /// Return the patch which will be produced as output for the given radius
+  static cv::Rect_<float> getOutputPatch(int x, int y, float radius, const Config& config);
+
+  /// Compute the score of all candidates centered at (x,center_y) for x in xCenters
+  /// yImg and greenImg are integral images (CV_32SC1), radiusImg is CV_32FC1
+  void scoreRow(int centerY, const std::vector<int>& xCenters, const cv::Mat& radiusImg, const cv::Mat& yImg,
+                const cv::Mat& greenImg, const Config& config);
+
+  /// Access to the results of the last call to scoreRow, idx is the index in xCenters
+  Status getStatus(size_t idx) const;
+  float getRadius(size_t idx) const;
+  double getScore(size_t idx) const;
+  const cv::Rect_<float>& getOutputPatch(size_t idx) const;
+
+private:
+  enum PatchType
+  {
+    Boundary,
+    Inner,
+    InnerAbove,
+    InnerBelow,
+    BoundaryAbove,
+    NbPatchTypes
+  };
+
+  std::vector<Status> status;
+  std::vector<float> radiuses;
+  std::vector<double> scores;
+  std::vector<cv::Rect_<float>> outputPatches;
+
+  /// Index of the candidate associated to each entry of the batches
+  std::vector<size_t> batchCandidates;
+
+  /// One batch per type of patch
+  Utils::PatchBatch batches[NbPatchTypes];
+
+  /// Buffers for the sums of the patches
+  std::vector<int> ySums[NbPatchTypes];
+  std::vector<int> greenSums[NbPatchTypes];
+};
+
+}  // namespace Filters
+}  // namespace Vision
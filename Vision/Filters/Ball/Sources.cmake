@@ -1,4 +1,5 @@
 set (SOURCES
   BallByII.cpp
+  BallScoringEngine.cpp
   BallFactory.cpp
 )
@@ -20,7 +20,11 @@ void Histogram::process()
 {
   cv::Mat src = *(getDependency().getImg());
 
-  std::vector<cv::Mat> yuv;
+  std::vector<cv::Mat> yuv(src.channels());
+  for (cv::Mat& channel : yuv)
+  {
+    channel = getScratch(src.size(), CV_MAKETYPE(src.depth(), 1));
+  }
   split(src, yuv);
 
   int histSize = bins;
@@ -44,7 +48,7 @@ void Histogram::process()
   int hist_h = src.rows;
   int bin_w = cvRound((double)hist_w / histSize);
 
-  img() = cv::Mat(hist_h, hist_w, CV_8UC3, cv::Scalar(0, 0, 0));
+  allocateImg(cv::Size(hist_w, hist_h), CV_8UC3).setTo(cv::Scalar(0, 0, 0));
 
   // Normalize the result to [ 0, img().rows ]
   cv::normalize(yHist, yHist, 0, img().rows, cv::NORM_MINMAX, -1, cv::Mat());
@@ -2,6 +2,10 @@
 
 #include <opencv2/imgproc/imgproc.hpp>
 #include "rhoban_utils/timing/benchmark.h"
+#include "rhoban_utils/util.h"
+
+#include <algorithm>
+#include <vector>
 
 using rhoban_utils::Benchmark;
 
@@ -11,12 +15,80 @@ namespace Filters
 {
 void Integral::setParameters()
 {
+  tileSize = ParamInt(1, 1, 64);
+  params()->define<ParamInt>("tileSize", &tileSize);
 }
 
 void Integral::process()
 {
   cv::Mat src = *(getDependency().getImg());
-  integral(src, img(), CV_32S);
+  int startRow = getGroundStartRow(src.rows);
+  if (tileSize > 1)
+  {
+    computeTiled(src, startRow);
+    return;
+  }
+  if (startRow == 0)
+  {
+    integral(src, img(), CV_32S);
+    return;
+  }
+  cv::Mat& dst = allocateImg(cv::Size(src.cols + 1, src.rows + 1), CV_32SC1);
+  if (startRow >= src.rows)
+  {
+    dst.setTo(0);
+    return;
+  }
+  dst.rowRange(0, startRow).setTo(0);
+  // The integral of the sub-image starts with a row of 0, consistent with the rows above
+  cv::Mat dstBelow = dst.rowRange(startRow, src.rows + 1);
+  integral(src.rowRange(startRow, src.rows), dstBelow, CV_32S);
+}
+
+void Integral::computeTiled(const cv::Mat& src, int startRow)
+{
+  if (src.type() != CV_8UC1)
+  {
+    throw std::runtime_error(DEBUG_INFO + "tiled mode requires a CV_8UC1 input");
+  }
+  int tile = tileSize;
+  int tileRows = (src.rows + tile - 1) / tile;
+  int tileCols = (src.cols + tile - 1) / tile;
+  cv::Mat& dst = allocateImg(cv::Size(tileCols + 1, tileRows + 1), CV_32SC1);
+  // Tiles entirely above startRow are empty
+  int firstTileRow = startRow / tile;
+  dst.rowRange(0, firstTileRow + 1).setTo(0);
+  std::vector<int> tileSums(tileCols);
+  for (int tileRow = firstTileRow; tileRow < tileRows; tileRow++)
+  {
+    // Sum of the pixels of each tile on this row of tiles
+    std::fill(tileSums.begin(), tileSums.end(), 0);
+    int rowEnd = std::min((tileRow + 1) * tile, src.rows);
+    for (int row = std::max(tileRow * tile, startRow); row < rowEnd; row++)
+    {
+      const uchar* srcRow = src.ptr<uchar>(row);
+      for (int tileCol = 0; tileCol < tileCols; tileCol++)
+      {
+        int colEnd = std::min((tileCol + 1) * tile, src.cols);
+        int sum = 0;
+        for (int col = tileCol * tile; col < colEnd; col++)
+        {
+          sum += srcRow[col];
+        }
+        tileSums[tileCol] += sum;
+      }
+    }
+    // Accumulating on the previous row of the integral image
+    const int* prevRow = dst.ptr<int>(tileRow);
+    int* dstRow = dst.ptr<int>(tileRow + 1);
+    int rowSum = 0;
+    dstRow[0] = 0;
+    for (int tileCol = 0; tileCol < tileCols; tileCol++)
+    {
+      rowSum += tileSums[tileCol];
+      dstRow[tileCol + 1] = prevRow[tileCol + 1] + rowSum;
+    }
+  }
 }
 }  // namespace Filters
 }  // namespace Vision
@@ -11,6 +11,16 @@ namespace Filters
  * Integral
  *
  * Outputs the integral image formed by the single channel input image
+ *
+ * When the horizon mask of the pipeline is enabled, only the pixels below the
+ * horizon are integrated, pixels above are considered as 0. The output keeps
+ * the usual (rows+1)x(cols+1) CV_32SC1 format.
+ *
+ * When tileSize is above 1, the output is the integral image sampled every
+ * tileSize pixels: out(i,j) is the sum of the input pixels in
+ * [0,i*tileSize[x[0,j*tileSize[ (clamped to the image). Its size is
+ * (ceil(rows/tileSize)+1)x(ceil(cols/tileSize)+1), only 8-bit inputs are
+ * supported in this mode.
  */
 class Integral : public Filter
 {
@@ -33,6 +43,11 @@ protected:
   virtual void setParameters() override;
 
 private:
+  /// Compute the integral image sampled every tileSize pixels
+  void computeTiled(const cv::Mat& src, int startRow);
+
+  /// Size of the tiles in tiled mode, 1 for a full resolution integral image [px]
+  ParamInt tileSize;
 };
 }  // namespace Filters
 }  // namespace Vision
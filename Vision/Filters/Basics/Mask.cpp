@@ -13,7 +13,8 @@ void Mask::process()
   cv::Mat src = *(getDependency(srcName).getImg());
   cv::Mat mask = *(getDependency(maskName).getImg());
 
-  cv::Mat tmp = src.clone();
+  cv::Mat& tmp = allocateImg(src.size(), src.type());
+  src.copyTo(tmp);
   float ratio = ((float)src.cols) / mask.cols;
 
   // TODO the map seems to be parsed in the wrong order, I think it should be
@@ -38,7 +39,6 @@ void Mask::process()
       }
     }
   }
-  img() = tmp;
 }
 }  // namespace Filters
 }  // namespace Vision
@@ -6,7 +6,9 @@
 #include <opencv2/calib3d/calib3d.hpp>
 #include "rhoban_utils/timing/benchmark.h"
 #include <opencv2/core/core.hpp>
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
 
 using rhoban_utils::Benchmark;
@@ -58,6 +60,19 @@ void Undistort::setParameters()
 {
 }
 
+int Undistort::getOutputStartRow(int sourceStartRow) const
+{
+  // Interpolation also reads the row following the source position
+  for (int row = 0; row < (int)_rowMaxSourceY.size(); row++)
+  {
+    if (_rowMaxSourceY[row] + 1 >= sourceStartRow)
+    {
+      return row;
+    }
+  }
+  return _rowMaxSourceY.size();
+}
+
 cv::Mat Undistort::undistortOneShot(cv::Mat input)
 {
   cv::Mat output;
@@ -171,6 +186,17 @@ void Undistort::process()
     */
     Benchmark::close("Reading huge map1 and map2 (only once)");
 
+    // The horizon is known in the distorted image, rows of the output are
+    // compared with it through the largest source row they read
+    _rowMaxSourceY.assign(_map1Inverted.rows, std::numeric_limits<int>::min());
+    for (int i = 0; i < _map1Inverted.rows; i++)
+    {
+      for (int j = 0; j < _map1Inverted.cols; j++)
+      {
+        _rowMaxSourceY[i] = std::max<int>(_rowMaxSourceY[i], _map1Inverted.at<cv::Vec2s>(i, j)[1]);
+      }
+    }
+
     if (Filter::GPU_ON)
     {
       _map1Inverted.copyTo(map1);
@@ -193,7 +219,26 @@ void Undistort::process()
   else
   {
     Benchmark::open("remap");
-    cv::remap(input, img(), _map1Inverted, _map2, cv::INTER_LINEAR);
+    // Start row of the ground is expressed in the distorted input
+    int startRow = getOutputStartRow(getGroundStartRow(input.rows));
+    if (startRow == 0)
+    {
+      cv::remap(input, img(), _map1Inverted, _map2, cv::INTER_LINEAR);
+    }
+    else if (startRow >= _map1Inverted.rows)
+    {
+      // No ground visible, nothing to remap
+      allocateImg(_map1Inverted.size(), input.type()).setTo(0);
+    }
+    else
+    {
+      // Only the rows below the horizon are remapped
+      cv::Mat& output = allocateImg(_map1Inverted.size(), input.type());
+      output.rowRange(0, startRow).setTo(0);
+      cv::Mat outputBelow = output.rowRange(startRow, output.rows);
+      cv::remap(input, outputBelow, _map1Inverted.rowRange(startRow, output.rows), _map2.rowRange(startRow, output.rows),
+                cv::INTER_LINEAR);
+    }
     Benchmark::close("remap");
   }
 }
@@ -26,6 +26,10 @@ public:
 
   cv::Mat undistortOneShot(cv::Mat);
 
+  // Return the first row of the undistorted image reading pixels of the
+  // distorted image at or below 'sourceStartRow'
+  int getOutputStartRow(int sourceStartRow) const;
+
 protected:
   /**
    * @Inherit
@@ -37,6 +41,8 @@ protected:
 private:
   bool _first = true;
   cv::Mat _map1, _map2, _map1Inverted;
+  // Largest row of the distorted image read by each row of the output
+  std::vector<int> _rowMaxSourceY;
   cv::UMat map1, map2;
 };
 }  // namespace Filters
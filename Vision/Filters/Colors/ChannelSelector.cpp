@@ -14,15 +14,15 @@ void ChannelSelector::setParameters()
 void ChannelSelector::process()
 {
   cv::Mat src = *(getDependency().getImg());
-  std::vector<cv::Mat> channels;
-  split(src, channels);
-  if (channel >= (int)channels.size())
+  if (channel >= src.channels())
   {
     std::ostringstream oss;
-    oss << "Asking for channel '" << channel << "' while image has " << channels.size() << " channels.";
+    oss << "Asking for channel '" << channel << "' while image has " << src.channels() << " channels.";
     throw std::runtime_error(oss.str());
   }
-  img() = channels[channel];
+  // Extracting a single channel avoids allocating the other ones
+  cv::Mat& dst = allocateImg(src.size(), CV_MAKETYPE(src.depth(), 1));
+  cv::extractChannel(src, dst, channel);
 }
 }  // namespace Filters
 }  // namespace Vision
@@ -2,6 +2,8 @@
 
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include <algorithm>
+
 namespace Vision
 {
 namespace Filters
@@ -27,13 +29,18 @@ void ColorBounding::process()
 {
   cv::Mat src = *(getDependency().getImg());
 
-  cv::Mat temp(src.size(), 0, cv::Scalar(0));  // Unsigned char mat
+  cv::Mat& dst = allocateImg(src.size(), CV_8UC1);
   cv::Scalar lowLimit = cv::Scalar(minY, minU, minV);
   cv::Scalar highLimit = cv::Scalar(maxY, maxU, maxV);
 
-  inRange(src, lowLimit, highLimit, temp);
-
-  img() = temp;
+  // Pixels above the horizon are set to 0
+  int startRow = std::min(getGroundStartRow(src.rows), src.rows);
+  dst.rowRange(0, startRow).setTo(0);
+  if (startRow < src.rows)
+  {
+    cv::Mat dstBelow = dst.rowRange(startRow, src.rows);
+    inRange(src.rowRange(startRow, src.rows), lowLimit, highLimit, dstBelow);
+  }
 }
 }  // namespace Filters
 }  // namespace Vision
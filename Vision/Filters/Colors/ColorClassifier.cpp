@@ -0,0 +1,119 @@
+#include "Filters/Colors/ColorClassifier.hpp"
+
+#include "Utils/YCrCb.hpp"
+
+#include <rhoban_utils/util.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Vision
+{
+namespace Filters
+{
+ColorClassifier::ColorClassifier() : MultiOutputFilter("ColorClassifier"), conversion("BGR2YCrCb")
+{
+}
+
+void ColorClassifier::process()
+{
+  cv::Mat src = *(getDependency().getImg());
+  if (src.type() != CV_8UC3)
+  {
+    throw std::runtime_error(DEBUG_INFO + " source image should be of type CV_8UC3");
+  }
+  int rows = src.rows;
+  int cols = src.cols;
+
+  std::map<std::string, cv::Mat> new_outputs;
+  cv::Mat labels = acquireOutput(src.size(), CV_8UC1);
+  new_outputs["labels"] = labels;
+  std::vector<cv::Mat> mask_imgs;
+  std::vector<uint8_t> mask_labels;
+  for (const std::string& class_name : masks)
+  {
+    mask_imgs.push_back(acquireOutput(src.size(), CV_8UC1));
+    mask_labels.push_back(lut.getLabel(class_name));
+    new_outputs[class_name] = mask_imgs.back();
+  }
+
+  cv::Mat row_buffers = getScratch(cv::Size(cols, 3), CV_8UC1);
+  uint8_t* y_row = row_buffers.ptr<uint8_t>(0);
+  uint8_t* u_row = row_buffers.ptr<uint8_t>(1);
+  uint8_t* v_row = row_buffers.ptr<uint8_t>(2);
+  Utils::YCrCb::RowConverter convertRow = Utils::YCrCb::getRowConverter(conversion);
+  const uint8_t* table = lut.data();
+  int shift = 8 - lut.getBits();
+  int bits = lut.getBits();
+
+  // Pixels above the horizon are labelled 0
+  int start_row = std::min(getGroundStartRow(rows), rows);
+  labels.rowRange(0, start_row).setTo(0);
+  for (cv::Mat& mask : mask_imgs)
+  {
+    mask.rowRange(0, start_row).setTo(0);
+  }
+
+  for (int row = start_row; row < rows; row++)
+  {
+    convertRow(src.ptr<uint8_t>(row), cols, y_row, u_row, v_row);
+    uint8_t* label_row = labels.ptr<uint8_t>(row);
+    for (int x = 0; x < cols; x++)
+    {
+      size_t cell = ((size_t)(y_row[x] >> shift) << (2 * bits)) | ((size_t)(u_row[x] >> shift) << bits) |
+                    (size_t)(v_row[x] >> shift);
+      label_row[x] = table[cell];
+    }
+    for (size_t idx = 0; idx < mask_imgs.size(); idx++)
+    {
+      uint8_t* mask_row = mask_imgs[idx].ptr<uint8_t>(row);
+      uint8_t label = mask_labels[idx];
+      for (int x = 0; x < cols; x++)
+      {
+        mask_row[x] = label_row[x] == label ? 255 : 0;
+      }
+    }
+  }
+
+  img() = labels;
+  setOutputs(std::move(new_outputs));
+}
+
+void ColorClassifier::fromJson(const Json::Value& v, const std::string& dir_name)
+{
+  Filter::fromJson(v, dir_name);
+  rhoban_utils::tryRead(v, "path", &path);
+  rhoban_utils::tryRead(v, "conversion", &conversion);
+  rhoban_utils::tryReadVector(v, "masks", &masks);
+  if (Utils::YCrCb::getRowConverter(conversion) == nullptr)
+  {
+    throw std::runtime_error(DEBUG_INFO + " unknown conversion '" + conversion + "'");
+  }
+  if (path == "")
+  {
+    throw std::runtime_error(DEBUG_INFO + " no path provided for the lookup table of '" + name + "'");
+  }
+  lut.load(dir_name + path);
+  for (const std::string& class_name : masks)
+  {
+    if (class_name == "labels")
+    {
+      throw std::runtime_error(DEBUG_INFO + " 'labels' can not be used as a class name");
+    }
+    // Throws if the class is unknown
+    lut.getLabel(class_name);
+  }
+}
+
+Json::Value ColorClassifier::toJson() const
+{
+  Json::Value v = Filter::toJson();
+  v["path"] = path;
+  v["conversion"] = conversion;
+  v["masks"] = rhoban_utils::vector2Json(masks);
+  return v;
+}
+
+}  // namespace Filters
+}  // namespace Vision
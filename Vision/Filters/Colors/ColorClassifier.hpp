@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Filters/Colors/MultiOutputFilter.hpp"
+#include "Utils/ColorLUT.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Vision
+{
+namespace Filters
+{
+/**
+ * ColorClassifier
+ *
+ * Label each pixel with a color class using a lookup table over the YCrCb
+ * cube (see Utils::ColorLUT), all the classes are segmented in a single pass
+ * with one table access per pixel.
+ *
+ * The image of the filter contains the label of each pixel (0 for unknown
+ * colors, i+1 for the i-th class of the table). Binary masks of the classes
+ * listed in 'masks' are computed in the same pass and are available through
+ * SplitterOutput. Pixels above the horizon mask are labelled 0.
+ */
+class ColorClassifier : public MultiOutputFilter
+{
+public:
+  ColorClassifier();
+
+  virtual void fromJson(const Json::Value& v, const std::string& dir_name) override;
+  virtual Json::Value toJson() const override;
+  virtual std::string getClassName() const override
+  {
+    return "ColorClassifier";
+  }
+
+protected:
+  /**
+   * @Inherit
+   */
+  virtual void process() override;
+
+private:
+  /// Path to the lookup table, relative to the directory of the pipeline
+  std::string path;
+
+  /// Color conversion applied to the source: 'BGR2YCrCb', 'RGB2YCrCb' or
+  /// 'none' if the source is already in YCrCb
+  std::string conversion;
+
+  /// Names of the classes for which a mask is provided
+  std::vector<std::string> masks;
+
+  Utils::ColorLUT lut;
+};
+}  // namespace Filters
+}  // namespace Vision
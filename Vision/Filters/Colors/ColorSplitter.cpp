@@ -0,0 +1,185 @@
+#include "Filters/Colors/ColorSplitter.hpp"
+
+#include "Utils/YCrCb.hpp"
+
+#include <rhoban_utils/util.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+
+namespace Vision
+{
+namespace Filters
+{
+namespace
+{
+/// bounds: minY, maxY, minU, maxU, minV, maxV
+void boundRow(const uint8_t* y_row, const uint8_t* u_row, const uint8_t* v_row, int cols, const int* bounds,
+              uint8_t* mask)
+{
+  for (int x = 0; x < cols; x++)
+  {
+    bool inside = (y_row[x] >= bounds[0]) & (y_row[x] <= bounds[1]) & (u_row[x] >= bounds[2]) &
+                  (u_row[x] <= bounds[3]) & (v_row[x] >= bounds[4]) & (v_row[x] <= bounds[5]);
+    mask[x] = inside ? 255 : 0;
+  }
+}
+
+}  // namespace
+
+ColorSplitter::ColorSplitter() : MultiOutputFilter("ColorSplitter"), conversion("BGR2YCrCb")
+{
+}
+
+void ColorSplitter::setParameters()
+{
+  for (ColorClass& c : classes)
+  {
+    c.minY = ParamInt(124, 0, 255, ParameterType::PARAM);
+    c.maxY = ParamInt(124, 0, 255, ParameterType::PARAM);
+    c.minU = ParamInt(124, 0, 255, ParameterType::PARAM);
+    c.maxU = ParamInt(124, 0, 255, ParameterType::PARAM);
+    c.minV = ParamInt(124, 0, 255, ParameterType::PARAM);
+    c.maxV = ParamInt(124, 0, 255, ParameterType::PARAM);
+
+    params()->define<ParamInt>(c.name + "_minY", &c.minY);
+    params()->define<ParamInt>(c.name + "_maxY", &c.maxY);
+    params()->define<ParamInt>(c.name + "_minU", &c.minU);
+    params()->define<ParamInt>(c.name + "_maxU", &c.maxU);
+    params()->define<ParamInt>(c.name + "_minV", &c.minV);
+    params()->define<ParamInt>(c.name + "_maxV", &c.maxV);
+  }
+}
+
+void ColorSplitter::checkOutputs() const
+{
+  if (Utils::YCrCb::getRowConverter(conversion) == nullptr)
+  {
+    throw std::runtime_error(DEBUG_INFO + " unknown conversion '" + conversion + "'");
+  }
+  std::set<std::string> names;
+  for (const std::string& channel : channels)
+  {
+    if (channel != "Y" && channel != "U" && channel != "V" && channel != "YUV")
+    {
+      throw std::runtime_error(DEBUG_INFO + " unknown channel '" + channel + "'");
+    }
+    if (!names.insert(channel).second)
+    {
+      throw std::runtime_error(DEBUG_INFO + " channel '" + channel + "' is provided twice");
+    }
+  }
+  for (const ColorClass& c : classes)
+  {
+    if (!names.insert(c.name).second)
+    {
+      throw std::runtime_error(DEBUG_INFO + " output '" + c.name + "' is provided twice");
+    }
+  }
+  if (names.size() == 0)
+  {
+    throw std::runtime_error(DEBUG_INFO + " no channel or class provided");
+  }
+}
+
+void ColorSplitter::process()
+{
+  cv::Mat src = *(getDependency().getImg());
+  if (src.type() != CV_8UC3)
+  {
+    throw std::runtime_error(DEBUG_INFO + " source image should be of type CV_8UC3");
+  }
+  int rows = src.rows;
+  int cols = src.cols;
+
+  // Acquiring all the outputs, masks first
+  std::map<std::string, cv::Mat> new_outputs;
+  std::vector<cv::Mat> masks;
+  std::vector<std::array<int, 6>> bounds;
+  for (ColorClass& c : classes)
+  {
+    masks.push_back(acquireOutput(src.size(), CV_8UC1));
+    new_outputs[c.name] = masks.back();
+    bounds.push_back({ c.minY, c.maxY, c.minU, c.maxU, c.minV, c.maxV });
+  }
+  for (const std::string& channel : channels)
+  {
+    new_outputs[channel] = acquireOutput(src.size(), channel == "YUV" ? CV_8UC3 : CV_8UC1);
+  }
+
+  // Planes which are not provided are only stored for the current row
+  cv::Mat row_buffers = getScratch(cv::Size(cols, 3), CV_8UC1);
+  cv::Mat* y_plane = new_outputs.count("Y") > 0 ? &new_outputs["Y"] : nullptr;
+  cv::Mat* u_plane = new_outputs.count("U") > 0 ? &new_outputs["U"] : nullptr;
+  cv::Mat* v_plane = new_outputs.count("V") > 0 ? &new_outputs["V"] : nullptr;
+  cv::Mat* yuv_img = new_outputs.count("YUV") > 0 ? &new_outputs["YUV"] : nullptr;
+
+  // Pixels above the horizon are set to 0 in the masks
+  int start_row = std::min(getGroundStartRow(rows), rows);
+  Utils::YCrCb::RowConverter convertRow = Utils::YCrCb::getRowConverter(conversion);
+
+  for (int row = 0; row < rows; row++)
+  {
+    const uint8_t* src_row = src.ptr<uint8_t>(row);
+    uint8_t* y_row = y_plane != nullptr ? y_plane->ptr<uint8_t>(row) : row_buffers.ptr<uint8_t>(0);
+    uint8_t* u_row = u_plane != nullptr ? u_plane->ptr<uint8_t>(row) : row_buffers.ptr<uint8_t>(1);
+    uint8_t* v_row = v_plane != nullptr ? v_plane->ptr<uint8_t>(row) : row_buffers.ptr<uint8_t>(2);
+    convertRow(src_row, cols, y_row, u_row, v_row);
+    if (yuv_img != nullptr)
+    {
+      Utils::YCrCb::interleaveRow(y_row, u_row, v_row, cols, yuv_img->ptr<uint8_t>(row));
+    }
+    for (size_t idx = 0; idx < masks.size(); idx++)
+    {
+      uint8_t* mask_row = masks[idx].ptr<uint8_t>(row);
+      if (row < start_row)
+      {
+        std::memset(mask_row, 0, cols);
+      }
+      else
+      {
+        boundRow(y_row, u_row, v_row, cols, bounds[idx].data(), mask_row);
+      }
+    }
+  }
+
+  // Main image is the first output
+  img() = masks.size() > 0 ? masks[0] : new_outputs.at(channels[0]);
+  setOutputs(std::move(new_outputs));
+}
+
+void ColorSplitter::fromJson(const Json::Value& v, const std::string& dir_name)
+{
+  rhoban_utils::tryRead(v, "conversion", &conversion);
+  rhoban_utils::tryReadVector(v, "channels", &channels);
+  std::vector<std::string> class_names;
+  rhoban_utils::tryReadVector(v, "classes", &class_names);
+  // Parameters of the classes are defined in Filter::fromJson
+  classes = std::vector<ColorClass>(class_names.size());
+  for (size_t idx = 0; idx < class_names.size(); idx++)
+  {
+    classes[idx].name = class_names[idx];
+  }
+  checkOutputs();
+  Filter::fromJson(v, dir_name);
+}
+
+Json::Value ColorSplitter::toJson() const
+{
+  Json::Value v = Filter::toJson();
+  v["conversion"] = conversion;
+  v["channels"] = rhoban_utils::vector2Json(channels);
+  std::vector<std::string> class_names;
+  for (const ColorClass& c : classes)
+  {
+    class_names.push_back(c.name);
+  }
+  v["classes"] = rhoban_utils::vector2Json(class_names);
+  return v;
+}
+
+}  // namespace Filters
+}  // namespace Vision
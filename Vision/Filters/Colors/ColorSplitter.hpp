@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Filters/Colors/MultiOutputFilter.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Vision
+{
+namespace Filters
+{
+/**
+ * ColorSplitter
+ *
+ * Fused replacement for ColorConverter + ChannelSelector + ColorBounding:
+ * converts the source to YCrCb, extracts the requested channels and computes
+ * a binary mask for each color class in a single pass over the source.
+ *
+ * Conversion matches the one of ColorConverter with 'BGR2YCrCb', therefore
+ * the bounds used with ColorBounding remain valid. Each class 'c' has the
+ * parameters c_minY, c_maxY, c_minU, c_maxU, c_minV and c_maxV. As in
+ * ColorBounding, masks are empty above the horizon mask of the pipeline.
+ *
+ * Outputs are retrieved by other filters through SplitterOutput, the image of
+ * this filter is the first output (masks first, then channels).
+ */
+class ColorSplitter : public MultiOutputFilter
+{
+public:
+  ColorSplitter();
+
+  virtual void fromJson(const Json::Value& v, const std::string& dir_name) override;
+  virtual Json::Value toJson() const override;
+  virtual std::string getClassName() const override
+  {
+    return "ColorSplitter";
+  }
+
+protected:
+  /**
+   * @Inherit
+   */
+  virtual void process() override;
+
+  virtual void setParameters() override;
+
+private:
+  /// Bounds of a color class in YCrCb space
+  struct ColorClass
+  {
+    std::string name;
+    ParamInt minY, maxY, minU, maxU, minV, maxV;
+  };
+
+  /// Throw if names of outputs are not valid or not unique
+  void checkOutputs() const;
+
+  /// Color conversion applied to the source: 'BGR2YCrCb', 'RGB2YCrCb' or
+  /// 'none' if the source is already in YCrCb
+  std::string conversion;
+
+  /// Channels provided among 'Y', 'U', 'V' and 'YUV' (all channels)
+  std::vector<std::string> channels;
+
+  /// Names of the classes provided, addresses of 'classes' elements are bound
+  /// to the parameters and must not change once defined
+  std::vector<ColorClass> classes;
+};
+
+}  // namespace Filters
+}  // namespace Vision
@@ -2,7 +2,10 @@
 
 #include "ChannelSelector.hpp"
 #include "ColorBounding.hpp"
+#include "ColorClassifier.hpp"
 #include "ColorConverter.hpp"
+#include "ColorSplitter.hpp"
+#include "SplitterOutput.hpp"
 
 #include "../FilterFactory.hpp"
 
@@ -14,7 +17,10 @@ void registerColorsFilters(FilterFactory* ff)
 {
   ff->registerBuilder("ChannelSelector", []() { return std::unique_ptr<Filter>(new ChannelSelector()); });
   ff->registerBuilder("ColorBounding", []() { return std::unique_ptr<Filter>(new ColorBounding()); });
+  ff->registerBuilder("ColorClassifier", []() { return std::unique_ptr<Filter>(new ColorClassifier()); });
   ff->registerBuilder("ColorConverter", []() { return std::unique_ptr<Filter>(new ColorConverter()); });
+  ff->registerBuilder("ColorSplitter", []() { return std::unique_ptr<Filter>(new ColorSplitter()); });
+  ff->registerBuilder("SplitterOutput", []() { return std::unique_ptr<Filter>(new SplitterOutput()); });
 }
 
 }  // namespace Filters
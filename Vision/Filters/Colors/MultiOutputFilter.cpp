@@ -0,0 +1,44 @@
+#include "Filters/Colors/MultiOutputFilter.hpp"
+
+#include "Filters/Pipeline.hpp"
+
+#include <rhoban_utils/util.h>
+
+#include <stdexcept>
+
+namespace Vision
+{
+namespace Filters
+{
+MultiOutputFilter::MultiOutputFilter(const std::string& name) : Filter(name)
+{
+}
+
+cv::Mat MultiOutputFilter::getOutput(const std::string& output_name) const
+{
+  std::lock_guard<std::mutex> lock(outputs_mutex);
+  auto it = outputs.find(output_name);
+  if (it == outputs.end())
+  {
+    throw std::runtime_error(DEBUG_INFO + " no output named '" + output_name + "' in filter '" + name + "'");
+  }
+  return it->second;
+}
+
+cv::Mat MultiOutputFilter::acquireOutput(const cv::Size& size, int type)
+{
+  if (getPipeline() == nullptr)
+  {
+    return cv::Mat(size, type);
+  }
+  return getPipeline()->getFramePool().acquire(size, type);
+}
+
+void MultiOutputFilter::setOutputs(std::map<std::string, cv::Mat>&& new_outputs)
+{
+  std::lock_guard<std::mutex> lock(outputs_mutex);
+  outputs = std::move(new_outputs);
+}
+
+}  // namespace Filters
+}  // namespace Vision
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Filters/Filter.hpp"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace Vision
+{
+namespace Filters
+{
+/**
+ * MultiOutputFilter
+ *
+ * Base class for filters producing several named images in a single step,
+ * outputs are exposed to other filters through SplitterOutput
+ */
+class MultiOutputFilter : public Filter
+{
+public:
+  MultiOutputFilter(const std::string& name);
+
+  /// Return the output with the given name computed during the last step,
+  /// throws if the filter has no such output
+  cv::Mat getOutput(const std::string& output_name) const;
+
+protected:
+  /// Return a buffer from the pipeline FramePool
+  cv::Mat acquireOutput(const cv::Size& size, int type);
+
+  /// Replace the outputs of the previous step
+  void setOutputs(std::map<std::string, cv::Mat>&& new_outputs);
+
+private:
+  /// Outputs of the last step, indexed by name
+  std::map<std::string, cv::Mat> outputs;
+  mutable std::mutex outputs_mutex;
+};
+
+}  // namespace Filters
+}  // namespace Vision
@@ -1,6 +1,10 @@
 set (SOURCES
   ChannelSelector.cpp
   ColorBounding.cpp
+  ColorClassifier.cpp
   ColorConverter.cpp
+  ColorSplitter.cpp
   ColorsFactory.cpp
+  MultiOutputFilter.cpp
+  SplitterOutput.cpp
 )
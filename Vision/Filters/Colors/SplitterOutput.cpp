@@ -0,0 +1,36 @@
+#include "Filters/Colors/SplitterOutput.hpp"
+
+#include "Filters/Colors/MultiOutputFilter.hpp"
+
+#include <rhoban_utils/util.h>
+
+#include <stdexcept>
+
+namespace Vision
+{
+namespace Filters
+{
+void SplitterOutput::process()
+{
+  const MultiOutputFilter* splitter = dynamic_cast<const MultiOutputFilter*>(&getDependency());
+  if (splitter == nullptr)
+  {
+    throw std::runtime_error(DEBUG_INFO + " dependency of '" + name + "' does not provide several outputs");
+  }
+  img() = splitter->getOutput(output);
+}
+
+void SplitterOutput::fromJson(const Json::Value& v, const std::string& dir_name)
+{
+  Filter::fromJson(v, dir_name);
+  rhoban_utils::tryRead(v, "output", &output);
+}
+
+Json::Value SplitterOutput::toJson() const
+{
+  Json::Value v = Filter::toJson();
+  v["output"] = output;
+  return v;
+}
+}  // namespace Filters
+}  // namespace Vision
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Filters/Filter.hpp"
+
+namespace Vision
+{
+namespace Filters
+{
+/**
+ * SplitterOutput
+ *
+ * Provide one of the outputs of a MultiOutputFilter (e.g. ColorSplitter) as
+ * image, the buffer is shared with the dependency and is not copied
+ */
+class SplitterOutput : public Filter
+{
+public:
+  SplitterOutput() : Filter("SplitterOutput")
+  {
+  }
+
+  virtual void fromJson(const Json::Value& v, const std::string& dir_name) override;
+  virtual Json::Value toJson() const override;
+  virtual std::string getClassName() const override
+  {
+    return "SplitterOutput";
+  }
+
+protected:
+  /**
+   * @Inherit
+   */
+  virtual void process() override;
+
+private:
+  /// Name of the output in the dependency
+  std::string output;
+};
+}  // namespace Filters
+}  // namespace Vision
@@ -2,6 +2,15 @@
 
 #include "CameraState/CameraState.hpp"
 
+#include <robocup_referee/constants.h>
+#include <rhoban_utils/angle.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using robocup_referee::Constants;
+
 namespace Vision
 {
 namespace Filters
@@ -22,11 +31,123 @@ void BallRadiusProvider::setParameters()
   nbRows = ParamInt(4, 2, 200);
   params()->define<ParamInt>("nbCols", &nbCols);
   params()->define<ParamInt>("nbRows", &nbRows);
+  useCache = ParamInt(0, 0, 1);
+  maxHeightDiff = ParamFloat(0.002, 0, 0.1);
+  maxAngleDiff = ParamFloat(0.1, 0, 5);
+  useAnalytic = ParamInt(0, 0, 1);
+  params()->define<ParamInt>("useCache", &useCache);
+  params()->define<ParamFloat>("maxHeightDiff", &maxHeightDiff);
+  params()->define<ParamFloat>("maxAngleDiff", &maxAngleDiff);
+  params()->define<ParamInt>("useAnalytic", &useAnalytic);
 }
 
 void BallRadiusProvider::process()
 {
   cv::Size size = getDependency().getImg()->size();
+  const Utils::CameraState& cs = getCS();
+  double camera_height = cs.cameraToWorld.translation().z();
+  Eigen::Vector3d down_in_camera = cs.worldToCamera.linear() * Eigen::Vector3d(0, 0, -1);
+  if (useCache && isCacheValid(size, camera_height, down_in_camera))
+  {
+    // Consumers only read the image, sharing it is safe
+    img() = cachedRadiuses;
+    return;
+  }
+  cv::Mat& dst = allocateImg(size, CV_32FC1);
+  if (useAnalytic)
+  {
+    computeAnalytic(size, dst);
+  }
+  else
+  {
+    computeInterpolated(size, dst);
+  }
+  if (!useCache)
+  {
+    cachedRadiuses.release();
+    return;
+  }
+  cachedRadiuses = dst;
+  cachedHeight = camera_height;
+  cachedDown = down_in_camera;
+  cachedNbCols = nbCols;
+  cachedNbRows = nbRows;
+  cachedAnalytic = useAnalytic;
+}
+
+bool BallRadiusProvider::isCacheValid(const cv::Size& size, double camera_height,
+                                      const Eigen::Vector3d& down_in_camera) const
+{
+  if (cachedRadiuses.empty() || cachedRadiuses.size() != size || cachedNbCols != nbCols ||
+      cachedNbRows != nbRows || cachedAnalytic != useAnalytic)
+  {
+    return false;
+  }
+  double angle_diff = rhoban_utils::rad2deg(std::acos(std::min(1.0, cachedDown.dot(down_in_camera))));
+  return std::fabs(camera_height - cachedHeight) <= maxHeightDiff && angle_diff <= maxAngleDiff;
+}
+
+void BallRadiusProvider::computeAnalytic(const cv::Size& size, cv::Mat& dst)
+{
+  const Utils::CameraState& cs = getCS();
+  const rhoban::CameraModel& model = cs.getCameraModel();
+  float fx = model.getFocalX();
+  float fy = model.getFocalY();
+  float cx = model.getCenterX();
+  float cy = model.getCenterY();
+  float ball_radius = Constants::field.ball_radius;
+  // Distance between the camera and the plane of the ball centers along z
+  float height = cs.cameraToWorld.translation().z() - ball_radius;
+  if (height <= 0)
+  {
+    dst.setTo(0);
+    return;
+  }
+  // r(i,j): coefficient i,j of the rotation from camera to world
+  Eigen::Matrix3f r = cs.cameraToWorld.linear().cast<float>();
+
+  // Normalized x coordinates of the view vector for each column
+  std::vector<float> xn(size.width);
+  for (int col = 0; col < size.width; col++)
+  {
+    xn[col] = (col - cx) / fx;
+  }
+
+  for (int row = 0; row < size.height; row++)
+  {
+    float yn = (row - cy) / fy;
+    // Direction of the ray in world is dir = base + xn * r.col(0), with a view vector in camera (xn,yn,1)
+    float base_x = r(0, 1) * yn + r(0, 2);
+    float base_y = r(1, 1) * yn + r(1, 2);
+    float base_z = r(2, 1) * yn + r(2, 2);
+    float* dst_row = dst.ptr<float>(row);
+#pragma omp simd
+    for (int col = 0; col < size.width; col++)
+    {
+      float x = xn[col];
+      float dir_x = base_x + r(0, 0) * x;
+      float dir_y = base_y + r(1, 0) * x;
+      float dir_z = base_z + r(2, 0) * x;
+      // Depth of the ball center in camera basis, since the view vector has z=1
+      float depth = height / -dir_z;
+      // Horizontal direction orthogonal to the ray (-dir_y, dir_x, 0), expressed in camera basis
+      // (bounded norm avoids NaN for a ray pointing exactly downward)
+      float inv_norm = 1 / std::sqrt(std::max(dir_x * dir_x + dir_y * dir_y, 1e-12f));
+      float alt_x = (-dir_y * r(0, 0) + dir_x * r(1, 0)) * inv_norm;
+      float alt_y = (-dir_y * r(0, 1) + dir_x * r(1, 1)) * inv_norm;
+      float alt_z = (-dir_y * r(0, 2) + dir_x * r(1, 2)) * inv_norm;
+      // First order approximation of the projection of a displacement of ball_radius along alt
+      float du = fx * (alt_x - x * alt_z);
+      float dv = fy * (alt_y - yn * alt_z);
+      float radius = ball_radius * std::sqrt(du * du + dv * dv) / depth;
+      // Pixels above horizon have no ball radius
+      dst_row[col] = dir_z < 0 ? radius : 0;
+    }
+  }
+}
+
+void BallRadiusProvider::computeInterpolated(const cv::Size& size, cv::Mat& tmp_img)
+{
   // 1: Compute key columns and key rows
   std::vector<int> key_cols, key_rows;
   // 1.a: always select extreme pixels
@@ -47,8 +168,7 @@ void BallRadiusProvider::process()
   key_cols.push_back(size.width - 1);
   key_rows.push_back(size.height - 1);
 
-  // 2: create image
-  cv::Mat tmp_img(size, CV_32FC1);
+  // 2: image is provided by the caller
 
   // 3: Place values at key points
   for (int col : key_cols)
@@ -116,9 +236,6 @@ void BallRadiusProvider::process()
       }
     }
   }
-
-  // 6: Affect img
-  img() = tmp_img;
 }
 }  // namespace Filters
 }  // namespace Vision
@@ -2,6 +2,8 @@
 
 #include "Filters/Filter.hpp"
 
+#include <Eigen/Core>
+
 namespace Vision
 {
 namespace Filters
@@ -10,6 +12,16 @@ namespace Filters
 /// - for each pixel, the value is the expected radius of the ball inside the image
 /// In order to spare computing power, only a subset of the required value is
 /// computed. Values between those points are obtained through interpolation.
+///
+/// The expected radius only depends on the height of the camera and on its
+/// orientation with respect to the vertical. When useCache is enabled, the
+/// previous image is reused as long as these values did not change more than
+/// the tolerances.
+///
+/// When useAnalytic is enabled, the radius is evaluated at every pixel with a
+/// pinhole model (distortion is neglected) and a first order approximation of
+/// the projection of the ball side, which is cheaper than the exact
+/// computation at key points.
 class BallRadiusProvider : public Filter
 {
 public:
@@ -25,10 +37,36 @@ protected:
   virtual void setParameters() override;
 
 private:
+  /// Compute the radius at key points and interpolate between them
+  void computeInterpolated(const cv::Size& size, cv::Mat& dst);
+
+  /// Compute the radius at every pixel with the analytic approximation
+  void computeAnalytic(const cv::Size& size, cv::Mat& dst);
+
+  /// Return true if the previous image can be used for the current camera state
+  bool isCacheValid(const cv::Size& size, double camera_height, const Eigen::Vector3d& down_in_camera) const;
+
   /// The number of columns where the 'exact' value is computed
   ParamInt nbCols;
   /// The number of rows where the 'exact' value is computed
   ParamInt nbRows;
+  /// Reuse the previous image when the camera pose did not change (0 or 1)
+  ParamInt useCache;
+  /// Maximal difference of camera height for using the cache [m]
+  ParamFloat maxHeightDiff;
+  /// Maximal angle between the vertical axes seen from the camera for using the cache [deg]
+  ParamFloat maxAngleDiff;
+  /// Evaluate all pixels with the analytic approximation (0 or 1)
+  ParamInt useAnalytic;
+
+  /// Cached image, empty if there is none
+  cv::Mat cachedRadiuses;
+  /// Values used to compute cachedRadiuses
+  double cachedHeight;
+  Eigen::Vector3d cachedDown;
+  int cachedNbCols;
+  int cachedNbRows;
+  int cachedAnalytic;
 };
 
 }  // namespace Filters
@@ -1,5 +1,9 @@
 #include "Filters/Custom/ColorDensity.hpp"
 
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+
 using namespace std;
 
 namespace Vision
@@ -21,19 +25,33 @@ void ColorDensity::setParameters()
   params()->define<ParamInt>("kernel_size", &kernel_size);
   resize_factor = ParamFloat(1.0, 0.0, 1.0);
   params()->define<ParamFloat>("resize_factor", &resize_factor);
+  use_row_kernel = ParamInt(1, 0, 1);
+  params()->define<ParamInt>("use_row_kernel", &use_row_kernel);
 }
 
 void ColorDensity::process()
 {
   std::string greenIIName = _dependencies[0];  // Integral image
-  cv::Mat greenII = (getDependency(greenIIName).getImg())->clone();
+  // Dependency is only read, no need to clone it
+  cv::Mat greenII = *(getDependency(greenIIName).getImg());
   int col_nb = (int)(resize_factor * (greenII.cols - 1));
   int row_nb = (int)(resize_factor * (greenII.rows - 1));
-  img() = cv::Mat(row_nb, col_nb, 0);
+  cv::Mat& dst = allocateImg(cv::Size(col_nb, row_nb), CV_8UC1);
+  if (use_row_kernel)
+  {
+    computePerRow(greenII, dst);
+  }
+  else
+  {
+    computePerPixel(greenII, dst);
+  }
+}
 
-  for (int x = 0; x < col_nb; x++)
+void ColorDensity::computePerPixel(const cv::Mat& greenII, cv::Mat& dst)
+{
+  for (int x = 0; x < dst.cols; x++)
   {
-    for (int y = 0; y < row_nb; y++)
+    for (int y = 0; y < dst.rows; y++)
     {
       int s = kernel_size / 2;
       int xm = max((int)(x / resize_factor) - s, 0), ym = max((int)(y / resize_factor) - s, 0);
@@ -45,7 +63,43 @@ void ColorDensity::process()
       double sum_sq =
           greenII.at<int>(yM, xM) - greenII.at<int>(ym, xM) - greenII.at<int>(yM, xm) + greenII.at<int>(ym, xm);
       int mean_v = (int)(sum_sq / kernel_vol);
-      img().at<uchar>(y, x) = min(mean_v, 255);
+      dst.at<uchar>(y, x) = min(mean_v, 255);
+    }
+  }
+}
+
+void ColorDensity::computePerRow(const cv::Mat& greenII, cv::Mat& dst)
+{
+  int s = kernel_size / 2;
+  // Kernel bounds along x are the same for all rows, computing them once with
+  // the same expression as computePerPixel ensures identical results. With
+  // resize_factor=1/k for an integer k, the centers are simply x*k
+  std::vector<int> x_min(dst.cols), x_max(dst.cols);
+  for (int x = 0; x < dst.cols; x++)
+  {
+    int center = (int)(x / resize_factor);
+    x_min[x] = max(center - s, 0);
+    x_max[x] = min(center + s, greenII.cols - 1);
+  }
+  // Vertical difference between the bottom and top rows of the kernel
+  cv::Mat col_sums(1, greenII.cols, CV_32SC1);
+  for (int y = 0; y < dst.rows; y++)
+  {
+    int center = (int)(y / resize_factor);
+    int ym = max(center - s, 0);
+    int yM = min(center + s, greenII.rows - 1);
+    int height = yM - ym;
+    // Vectorized by OpenCV
+    cv::subtract(greenII.row(yM), greenII.row(ym), col_sums);
+    const int* sums = col_sums.ptr<int>(0);
+    uchar* dst_row = dst.ptr<uchar>(y);
+    for (int x = 0; x < dst.cols; x++)
+    {
+      // Integral images are positive and growing: sum and kernel_vol are positive and integer division
+      // truncates as the conversion of the double division in computePerPixel
+      int sum = sums[x_max[x]] - sums[x_min[x]];
+      int kernel_vol = (x_max[x] - x_min[x]) * height;
+      dst_row[x] = (uchar)min(sum / kernel_vol, 255);
     }
   }
 }
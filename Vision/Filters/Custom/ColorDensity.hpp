@@ -30,6 +30,15 @@ private:
   ParamInt kernel_size;
   /* The resizing factor (0.5 makes the image 2 times smaller) */
   ParamFloat resize_factor;
+  /* Use the row-major implementation (1) or the original per-pixel one (0),
+     both produce the same image */
+  ParamInt use_row_kernel;
+
+  /* Fill dst by reading the four corners of each kernel in greenII */
+  void computePerPixel(const cv::Mat& greenII, cv::Mat& dst);
+  /* Fill dst row by row: the vertical differences of the integral image are
+     computed once per output row, then each pixel only requires two reads */
+  void computePerRow(const cv::Mat& greenII, cv::Mat& dst);
 
 protected:
   /**
@@ -22,23 +22,26 @@ void WhiteLines::setParameters()
 void WhiteLines::process()
 {
   std::string sourceName = _dependencies[0];
-  cv::Mat source = (getDependency(sourceName).getImg())->clone();
+  // Dependencies are only read, no need to clone them
+  cv::Mat source = *(getDependency(sourceName).getImg());
   std::string clippingName = _dependencies[1];
-  cv::Mat clipping = (getDependency(clippingName).getImg())->clone();
+  cv::Mat clipping = *(getDependency(clippingName).getImg());
   std::string whitelinecolorName = _dependencies[2];
-  cv::Mat whitelinecolor = (getDependency(whitelinecolorName).getImg())->clone();
+  cv::Mat whitelinecolor = *(getDependency(whitelinecolorName).getImg());
   int row_nb = source.rows;
   int col_nb = source.cols;
-  img() = cv::Mat(row_nb, col_nb, 0);
-  img().setTo(0);
+  allocateImg(cv::Size(col_nb, row_nb), CV_8UC1).setTo(0);
 
   int clipping_scale = source.rows / clipping.rows;
   int clipping_security = row_nb / 20;
 
+  // Pixels above the horizon are left to 0
+  int start_row = getGroundStartRow(row_nb);
+
   // TODO: faire un vrai masque
   for (int x = 0; x < col_nb; x++)
   {
-    for (int y = 0; y < row_nb; y++)
+    for (int y = start_row; y < row_nb; y++)
     {
       if (clipping.at<uchar>(y / clipping_scale, x / clipping_scale) > 0 &&
           clipping.at<uchar>(y / clipping_scale - clipping_security / clipping_scale, x / clipping_scale) > 0 &&
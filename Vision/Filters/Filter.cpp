@@ -47,7 +47,9 @@ Filter::Filter(const std::string& n, const Dependencies& dependencies)
   , _pipeline(nullptr)
   , monitor_scale(1)
   , rhio_initialized(false)
+  , rhio_node(nullptr)
   , warningExecutionTime(0.01)
+  , lastStepTime(0)
 {
   _defaultRoi = false;
   setParameters();
@@ -127,6 +129,15 @@ Utils::CameraState& Filter::getCS()
   }
 }
 
+int Filter::getGroundStartRow(int rows)
+{
+  if (_pipeline == nullptr)
+  {
+    return 0;
+  }
+  return _pipeline->getHorizonMask().getStartRow(_pipeline->getCameraState(), rows);
+}
+
 Pipeline* Filter::getPipeline()
 {
   if (_pipeline == NULL)
@@ -295,12 +306,43 @@ void Filter::runStep(UpdateType updateType)
 
   // Close filter benchmark
   double filterTime = Benchmark::close(name.c_str());
+  lastStepTime = filterTime;
+  latencies.record(filterTime);
   if (filterTime > warningExecutionTime)
   {
     out.warning("Filter '%s' took %f ms for step", name.c_str(), filterTime * 1000);
   }
 }
 
+double Filter::getLastStepTime() const
+{
+  return lastStepTime;
+}
+
+rhoban::LatencyHistogram& Filter::getLatencies()
+{
+  return latencies;
+}
+
+const rhoban::LatencyHistogram& Filter::getLatencies() const
+{
+  return latencies;
+}
+
+void Filter::publishLatencies()
+{
+  // Nothing to publish before the first step
+  if (!rhio_initialized)
+  {
+    return;
+  }
+  std::vector<double> percentiles = latencies.getPercentiles({ 0.5, 0.95, 0.99 });
+  rhio_node->setFloat("latency_p50", 1000 * percentiles[0]);
+  rhio_node->setFloat("latency_p95", 1000 * percentiles[1]);
+  rhio_node->setFloat("latency_p99", 1000 * percentiles[2]);
+  rhio_node->setFloat("latency_max", 1000 * latencies.getMax());
+}
+
 const Filter& Filter::getDependency(const std::string& name) const
 {
   if (_pipeline == nullptr)
@@ -325,6 +367,98 @@ const Filter& Filter::getDependency(int index) const
   return _pipeline->get(_dependencies[index]);
 }
 
+namespace
+{
+/// Typed accessors to RhIO values, used by the parameters bindings
+void readRhIO(RhIO::IONode* node, const std::string& name, int* value)
+{
+  *value = node->getInt(name);
+}
+
+void readRhIO(RhIO::IONode* node, const std::string& name, float* value)
+{
+  *value = node->getFloat(name);
+}
+
+void writeRhIO(RhIO::IONode* node, const std::string& name, int value)
+{
+  node->setInt(name, value);
+}
+
+void writeRhIO(RhIO::IONode* node, const std::string& name, float value)
+{
+  node->setFloat(name, value);
+}
+
+void declareRhIO(RhIO::IONode* node, const std::string& name, const ParamInt& param)
+{
+  node->newInt(name)->defaultValue(param.value)->minimum(param.min)->maximum(param.max);
+}
+
+void declareRhIO(RhIO::IONode* node, const std::string& name, const ParamFloat& param)
+{
+  node->newFloat(name)->defaultValue(param.value)->minimum(param.min)->maximum(param.max);
+}
+
+template <typename T, typename Binding>
+void bindParameters(RhIO::IONode* node, ParamsContainerImpl::Container<Parameter<T>>& params,
+                    std::vector<Binding>* bindings)
+{
+  bindings->clear();
+  for (const auto& param : params)
+  {
+    // Parameters which already exist in RhIO (e.g. pipeline reloaded) keep their RhIO value
+    if (node->getValueType(param.first) == RhIO::NoValue)
+    {
+      declareRhIO(node, param.first, param.second);
+    }
+    Binding binding;
+    binding.name = param.first;
+    binding.param = &(param.second);
+    readRhIO(node, binding.name, &(binding.syncedValue));
+    if (binding.param->importFromRhIO())
+    {
+      binding.param->value = binding.syncedValue;
+    }
+    bindings->push_back(binding);
+  }
+}
+
+/// Copy to the parameters the values which have been modified in RhIO
+template <typename Binding>
+void importBindings(RhIO::IONode* node, std::vector<Binding>& bindings)
+{
+  for (Binding& binding : bindings)
+  {
+    if (!binding.param->importFromRhIO())
+    {
+      continue;
+    }
+    auto rhioValue = binding.syncedValue;
+    readRhIO(node, binding.name, &rhioValue);
+    if (rhioValue != binding.syncedValue)
+    {
+      binding.param->value = rhioValue;
+      binding.syncedValue = rhioValue;
+    }
+  }
+}
+
+/// Copy to RhIO the values of the parameters which have been modified by the filter
+template <typename Binding>
+void publishBindings(RhIO::IONode* node, std::vector<Binding>& bindings)
+{
+  for (Binding& binding : bindings)
+  {
+    if (binding.param->value != binding.syncedValue)
+    {
+      writeRhIO(node, binding.name, binding.param->value);
+      binding.syncedValue = binding.param->value;
+    }
+  }
+}
+}  // namespace
+
 void Filter::initRhIO(const std::string& path)
 {
   // Lazy init
@@ -336,61 +470,62 @@ void Filter::initRhIO(const std::string& path)
 
   std::string filterPath = path + getName();
   RhIO::Root.newChild(filterPath);
-  RhIO::IONode& node = RhIO::Root.child(filterPath);
+  rhio_node = &(RhIO::Root.child(filterPath));
 
   // Declare variable if they have not been declared yet
   try
   {
     // This will fail if node do not exist yet
-    node.getFloat("monitor_scale");
+    rhio_node->getFloat("monitor_scale");
   }
   catch (const std::logic_error& err)
   {
-    node.newFloat("monitor_scale")->defaultValue(monitor_scale)->minimum(0.01)->maximum(10);
+    rhio_node->newFloat("monitor_scale")->defaultValue(monitor_scale)->minimum(0.01)->maximum(10);
     // Advertise format
-    node.newFrame("out", "Output frame of the filter '" + getName() + "'");
+    rhio_node->newFrame("out", "Output frame of the filter '" + getName() + "'");
+    for (const std::string& stat : { "p50", "p95", "p99", "max" })
+    {
+      rhio_node->newFloat("latency_" + stat)->defaultValue(0)->comment("Duration of the steps of the filter [ms]");
+    }
   }
+
+  bindRhIOParameters();
+}
+
+void Filter::bindRhIOParameters()
+{
+  std::lock_guard<std::mutex> lock(_lockParams);
+  bindParameters<int>(rhio_node, _params.params<ParamInt>(), &rhio_int_bindings);
+  bindParameters<float>(rhio_node, _params.params<ParamFloat>(), &rhio_float_bindings);
 }
 
 void Filter::importFromRhIO(const std::string& path)
 {
   initRhIO(path);
-  std::string filterPath = path + getName();
-  RhIO::IONode& node = RhIO::Root.child(filterPath);
-  // Updating monitor scale
-  monitor_scale = node.getValueFloat("monitor_scale").value;
-  // Updating parameters
-  for (const auto& param : params()->params<ParamInt>())
+  // Parameters might have been defined since the last binding
+  bool bindingOutdated;
   {
-    if (!param.second.importFromRhIO())
-    {
-      continue;
-    }
-    if (node.getValueType(param.first) != RhIO::NoValue)
-    {
-      param.second.value = node.getInt(param.first);
-    }
+    std::lock_guard<std::mutex> lock(_lockParams);
+    bindingOutdated = _params.params<ParamInt>().size() != rhio_int_bindings.size() ||
+                      _params.params<ParamFloat>().size() != rhio_float_bindings.size();
   }
-  for (const auto& param : params()->params<ParamFloat>())
+  if (bindingOutdated)
   {
-    if (!param.second.importFromRhIO())
-    {
-      continue;
-    }
-    if (node.getValueType(param.first) != RhIO::NoValue)
-    {
-      param.second.value = node.getFloat(param.first);
-    }
+    bindRhIOParameters();
   }
+  // Updating monitor scale
+  monitor_scale = rhio_node->getFloat("monitor_scale");
+  // Updating parameters
+  std::lock_guard<std::mutex> lock(_lockParams);
+  importBindings(rhio_node, rhio_int_bindings);
+  importBindings(rhio_node, rhio_float_bindings);
 }
 
 void Filter::publishToRhIO(const std::string& path)
 {
   initRhIO(path);
-  std::string filterPath = path + getName();
-  RhIO::IONode& node = RhIO::Root.child(filterPath);
 
-  if (node.frameIsStreaming("out"))
+  if (rhio_node->frameIsStreaming("out"))
   {
     // Publish frame to RhIO
     int monitor_width = (int)(monitor_scale * img().cols);
@@ -408,27 +543,13 @@ void Filter::publishToRhIO(const std::string& path)
     // Resize image if necessary
     cv::Mat tmp_img2(monitor_height, monitor_width, CV_8UC3);
     cv::resize(tmp_img1, tmp_img2, cv::Size(monitor_width, monitor_height));
-    node.framePush("out", tmp_img2);
+    rhio_node->framePush("out", tmp_img2);
   }
 
-  // Publish parameters to RhIO if they have never been published
-  for (const auto& param : params()->params<ParamInt>())
-  {
-    if (node.getValueType(param.first) == RhIO::NoValue)
-    {
-      node.newInt(param.first)->defaultValue(param.second.value)->minimum(param.second.min)->maximum(param.second.max);
-    }
-  }
-  for (const auto& param : params()->params<ParamFloat>())
-  {
-    if (node.getValueType(param.first) == RhIO::NoValue)
-    {
-      node.newFloat(param.first)
-          ->defaultValue(param.second.value)
-          ->minimum(param.second.min)
-          ->maximum(param.second.max);
-    }
-  }
+  // Publish parameters modified by the filter itself
+  std::lock_guard<std::mutex> lock(_lockParams);
+  publishBindings(rhio_node, rhio_int_bindings);
+  publishBindings(rhio_node, rhio_float_bindings);
 }
 
 const Filter& Filter::getDependency() const
@@ -452,6 +573,30 @@ cv::Mat& Filter::img()
   }
 }
 
+cv::Mat Filter::getScratch(const cv::Size& size, int type)
+{
+  if (_pipeline == nullptr)
+  {
+    return cv::Mat(size, type);
+  }
+  return _pipeline->getFrameArena().acquire(size, type);
+}
+
+cv::Mat& Filter::allocateImg(const cv::Size& size, int type)
+{
+  // Releasing first allows to reuse the buffer if nobody else is using it
+  img().release();
+  if (_pipeline == nullptr)
+  {
+    img().create(size, type);
+  }
+  else
+  {
+    img() = _pipeline->getFramePool().acquire(size, type);
+  }
+  return img();
+}
+
 cv::Mat& Filter::cachedImg()
 {
   if (_availableImg == 0)
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <fstream>
 #include <opencv2/core/core.hpp>
+#include "utils/LatencyHistogram.h"
 #include "Utils/ParamsContainer.hpp"
 #include "Utils/SafePtr.hpp"
 
@@ -14,6 +15,11 @@
 
 #include "rhoban_geometry/circle.h"
 
+namespace RhIO
+{
+class IONode;
+}
+
 namespace Vision
 {
 namespace Utils
@@ -182,6 +188,19 @@ public:
    */
   void runStep(UpdateType updateType = UpdateType::forward);
 
+  /// Duration of the last call to runStep [s]
+  double getLastStepTime() const;
+
+  /// Distribution of the durations of runStep since the last reset, see
+  /// publishLatencies
+  rhoban::LatencyHistogram& getLatencies();
+  const rhoban::LatencyHistogram& getLatencies() const;
+
+  /// Publish the percentiles of the latencies to RhIO, scanning the histogram
+  /// is not free so it is left to the owner of the pipeline, it must not be
+  /// called while the filter is stepped
+  void publishLatencies();
+
   /// Initialize the display window
   void initWindow();
 
@@ -229,6 +248,13 @@ protected:
   virtual void importFromRhIO(const std::string& path);
   virtual void publishToRhIO(const std::string& path);
 
+  /**
+   * Bind all the ParamInt and ParamFloat of the filter to their RhIO values,
+   * declaring them if needed. Called again only when parameters have been
+   * defined since the last call
+   */
+  void bindRhIOParameters();
+
   /**
    * Return the Filter registered as dependency by its name
    */
@@ -252,9 +278,29 @@ protected:
    */
   cv::Mat& img();
 
+  /**
+   * Replace the output buffer by a buffer of the given size and type taken
+   * from the pipeline FramePool (content is undefined). Contrary to writing
+   * in place in img(), images previously obtained through getImg by other
+   * filters remain untouched. Return img()
+   */
+  cv::Mat& allocateImg(const cv::Size& size, int type);
+
+  /// Return a scratch buffer of the given size and type from the pipeline
+  /// FrameArena (content is undefined). The buffer is only valid until the
+  /// end of the current step and must not be used as output image
+  cv::Mat getScratch(const cv::Size& size, int type);
+
   /// Access to the cached Image
   cv::Mat& cachedImg();
 
+  /**
+   * Return the first row which can contain ground pixels in an image with
+   * 'rows' rows covering the camera field of view, according to the horizon
+   * mask of the pipeline. Returns 0 when the mask is disabled
+   */
+  int getGroundStartRow(int rows);
+
   /**
    * Filter implementation called by run (switch to next image)
    */
@@ -378,9 +424,40 @@ protected:
    */
   bool rhio_initialized;
 
+  /**
+   * RhIO node of the filter, resolved once in initRhIO
+   */
+  RhIO::IONode* rhio_node;
+
+  /**
+   * A parameter of the filter bound to its RhIO value
+   */
+  template <typename T>
+  struct RhIOBinding
+  {
+    std::string name;
+    /// Points inside _params, addresses are stable since parameters are never removed
+    Parameter<T>* param;
+    /// Value of the parameter on both sides after the last synchronization
+    T syncedValue;
+  };
+
+  /**
+   * Parameters bound to RhIO, values are only transferred when one of the
+   * sides differs from syncedValue
+   */
+  std::vector<RhIOBinding<int>> rhio_int_bindings;
+  std::vector<RhIOBinding<float>> rhio_float_bindings;
+
   /// If the step of the  filter is longer than the limit, a warning is shown. [s]
   double warningExecutionTime;
 
+  /// Duration of the last step of the filter [s]
+  double lastStepTime;
+
+  /// Durations of all the steps of the filter
+  rhoban::LatencyHistogram latencies;
+
   /**
    * Check and wait that dependencies are
    * fresh and updated
@@ -1,7 +1,12 @@
 #include <stdexcept>
 #include <list>
 #include <functional>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 #include "Filters/Source/Source.hpp"
 #include "Filters/Pipeline.hpp"
 #include <iostream>
@@ -17,13 +22,29 @@ using namespace rhoban_utils;
 
 namespace Vision
 {
-Pipeline::Pipeline() : _filters(), _rootFilters(), _children(), _filterThread(), _timestamp()
+Pipeline::Pipeline()
+  : _filters()
+  , _rootFilters()
+  , _children()
+  , _filterThread()
+  , _timestamp()
+  , _lastStepAllocations(0)
+  , _lastStepReuses(0)
+  , _lastStepScratchAllocations(0)
+  , _parallel(false)
+  , _nbWorkers(0)
 {
   cs = NULL;
+  for (const std::string& stage : getStages())
+  {
+    _stageLatencies[stage];
+  }
 }
 
 Pipeline::~Pipeline()
 {
+  // Join the workers before freeing the filters
+  _workers.reset();
   // Free Filters
   _rootFilters.clear();
   _children.clear();
@@ -111,10 +132,15 @@ Pipeline::FiltersMap& Pipeline::filters()
 
 void Pipeline::step(Filter::UpdateType updateType)
 {
+  TimeStamp stepStart = TimeStamp::now();
   Benchmark::open("Resolve dependencies");
   resolveDependencies();
   Benchmark::close("Resolve dependencies");
 
+  _framePool.resetStats();
+  // Scratch buffers of the previous step are not used anymore
+  _frameArena.reset();
+
   // Apply previous on nonDependency filters
   std::list<Filter*> list;
   std::map<std::string, int> dependenciesSolved;
@@ -164,6 +190,41 @@ void Pipeline::step(Filter::UpdateType updateType)
     }
   }
 
+  // CameraState has been updated by the sources
+  _horizonMask.invalidate();
+  TimeStamp sourcesEnd = TimeStamp::now();
+
+  if (_parallel)
+  {
+    Benchmark::open("Parallel filters");
+    try
+    {
+      runParallel(list, &dependenciesSolved);
+    }
+    catch (...)
+    {
+      Benchmark::closeUntil("Parallel filters");
+      throw;
+    }
+    Benchmark::close("Parallel filters");
+  }
+  else
+  {
+    runSequential(list, &dependenciesSolved);
+  }
+
+  _lastStepAllocations = _framePool.getAllocations();
+  _lastStepReuses = _framePool.getReuses();
+  _lastStepScratchAllocations = _frameArena.getAllocations();
+
+  TimeStamp stepEnd = TimeStamp::now();
+  _stageLatencies.at("sources").record(diffSec(stepStart, sourcesEnd));
+  _stageLatencies.at("filters").record(diffSec(sourcesEnd, stepEnd));
+  _stageLatencies.at("step").record(diffSec(stepStart, stepEnd));
+}
+
+void Pipeline::runSequential(std::list<Filter*> list, std::map<std::string, int>* dependenciesSolved)
+{
   // And sweep through topological order
   // Do no process a filter twice
   while (!list.empty())
@@ -174,8 +235,8 @@ void Pipeline::step(Filter::UpdateType updateType)
     for (auto& son : _children.at(filter->getName()))
     {
       std::string sonName = son->getName();
-      dependenciesSolved[sonName]++;
-      if ((size_t)dependenciesSolved[sonName] == _filters[sonName]->_dependencies.size())
+      (*dependenciesSolved)[sonName]++;
+      if ((size_t)(*dependenciesSolved)[sonName] == _filters[sonName]->_dependencies.size())
       {
         list.push_back(son);
       }
@@ -184,6 +245,190 @@ void Pipeline::step(Filter::UpdateType updateType)
   }
 }
 
+void Pipeline::runParallel(std::list<Filter*> ready, std::map<std::string, int>* dependenciesSolved)
+{
+  if (!_workers)
+  {
+    _workers.reset(new Utils::WorkerPool(_nbWorkers));
+  }
+
+  // Protects dependenciesSolved, nbRunning and error
+  std::mutex mutex;
+  std::condition_variable allDone;
+  int nbRunning = 0;
+  std::exception_ptr error;
+
+  // Must be called while holding 'mutex'
+  std::function<void(Filter*)> schedule;
+  schedule = [&](Filter* filter) {
+    nbRunning++;
+    _workers->push([&, filter]() {
+      std::exception_ptr filterError;
+      try
+      {
+        filter->runStep();
+      }
+      catch (...)
+      {
+        filterError = std::current_exception();
+      }
+      std::unique_lock<std::mutex> lock(mutex);
+      if (filterError && !error)
+      {
+        error = filterError;
+      }
+      // Once an error occured, let running filters finish without scheduling new ones
+      if (!error)
+      {
+        for (Filter* son : _children.at(filter->getName()))
+        {
+          int& solved = (*dependenciesSolved)[son->getName()];
+          solved++;
+          if ((size_t)solved == son->_dependencies.size())
+          {
+            schedule(son);
+          }
+        }
+      }
+      nbRunning--;
+      if (nbRunning == 0)
+      {
+        allDone.notify_all();
+      }
+    });
+  };
+
+  std::unique_lock<std::mutex> lock(mutex);
+  for (Filter* filter : ready)
+  {
+    schedule(filter);
+  }
+  allDone.wait(lock, [&nbRunning]() { return nbRunning == 0; });
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+void Pipeline::setParallel(bool parallel, int nb_workers)
+{
+  if (nb_workers != _nbWorkers)
+  {
+    _workers.reset();
+  }
+  _parallel = parallel;
+  _nbWorkers = nb_workers;
+}
+
+Utils::FramePool& Pipeline::getFramePool()
+{
+  return _framePool;
+}
+
+Utils::FrameArena& Pipeline::getFrameArena()
+{
+  return _frameArena;
+}
+
+Utils::HorizonMask& Pipeline::getHorizonMask()
+{
+  return _horizonMask;
+}
+
+int Pipeline::getLastStepAllocations() const
+{
+  return _lastStepAllocations;
+}
+
+int Pipeline::getLastStepReuses() const
+{
+  return _lastStepReuses;
+}
+
+int Pipeline::getLastStepScratchAllocations() const
+{
+  return _lastStepScratchAllocations;
+}
+
+bool Pipeline::isParallel() const
+{
+  return _parallel;
+}
+
+std::map<std::string, double> Pipeline::getLastStepTimes() const
+{
+  std::map<std::string, double> times;
+  for (const auto& entry : _filters)
+  {
+    times[entry.first] = entry.second->getLastStepTime();
+  }
+  return times;
+}
+
+std::vector<std::string> Pipeline::getStages() const
+{
+  return { "sources", "filters", "step" };
+}
+
+const rhoban::LatencyHistogram& Pipeline::getStageLatencies(const std::string& stage) const
+{
+  try
+  {
+    return _stageLatencies.at(stage);
+  }
+  catch (const std::out_of_range& e)
+  {
+    throw std::out_of_range(DEBUG_INFO + " unknown stage '" + stage + "'");
+  }
+}
+
+void Pipeline::resetLatencies()
+{
+  for (auto& entry : _stageLatencies)
+  {
+    entry.second.reset();
+  }
+  for (auto& entry : _filters)
+  {
+    entry.second->getLatencies().reset();
+  }
+}
+
+void Pipeline::publishLatencies()
+{
+  for (auto& entry : _filters)
+  {
+    entry.second->publishLatencies();
+  }
+}
+
+std::string Pipeline::dumpLatencies() const
+{
+  std::ostringstream oss;
+  oss << std::left << std::setw(30) << "name" << std::right << std::setw(10) << "count" << std::setw(10) << "p50"
+      << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max"
+      << "  [ms]" << std::endl;
+  auto dumpHistogram = [&oss](const std::string& name, const rhoban::LatencyHistogram& histogram) {
+    std::vector<double> percentiles = histogram.getPercentiles({ 0.5, 0.95, 0.99 });
+    oss << std::left << std::setw(30) << name << std::right << std::setw(10) << histogram.getCount() << std::fixed
+        << std::setprecision(3);
+    for (double value : percentiles)
+    {
+      oss << std::setw(10) << 1000 * value;
+    }
+    oss << std::setw(10) << 1000 * histogram.getMax() << std::endl;
+  };
+  for (const std::string& stage : getStages())
+  {
+    dumpHistogram("[" + stage + "]", _stageLatencies.at(stage));
+  }
+  for (const auto& entry : _filters)
+  {
+    dumpHistogram(entry.first, entry.second->getLatencies());
+  }
+  return oss.str();
+}
+
 void Pipeline::runStep()
 {
   step(Filter::UpdateType::forward);
@@ -249,7 +494,18 @@ Json::Value Pipeline::toJson() const
   {
     v.append(f.second->toJson());
   }
-  return v;
+  if (!_parallel && !_horizonMask.isEnabled())
+  {
+    return v;
+  }
+  // Executor and horizon mask options require the object format
+  Json::Value pipeline;
+  pipeline["filters"] = v;
+  pipeline["parallel"] = _parallel;
+  pipeline["nbWorkers"] = _nbWorkers;
+  pipeline["horizonMask"] = _horizonMask.isEnabled();
+  pipeline["horizonMargin"] = _horizonMask.getMargin();
+  return pipeline;
 }
 
 void Pipeline::addFiltersFromJson(const Json::Value& v, const std::string& dir_name)
@@ -313,6 +569,26 @@ void Pipeline::fromJson(const Json::Value& v, const std::string& dir_name)
   addFiltersFromJson(v, dir_name);
   std::cout << "There is now " << _filters.size() << " filters." << std::endl;
 
+  if (v.isObject())
+  {
+    bool parallel = _parallel;
+    int nb_workers = _nbWorkers;
+    rhoban_utils::tryRead(v, "parallel", &parallel);
+    rhoban_utils::tryRead(v, "nbWorkers", &nb_workers);
+    setParallel(parallel, nb_workers);
+    bool horizon_mask = _horizonMask.isEnabled();
+    int horizon_margin = _horizonMask.getMargin();
+    rhoban_utils::tryRead(v, "horizonMask", &horizon_mask);
+    rhoban_utils::tryRead(v, "horizonMargin", &horizon_margin);
+    if (horizon_margin < 0)
+    {
+      throw rhoban_utils::JsonParsingError(DEBUG_INFO + " horizonMargin should not be negative, got " +
+                                           std::to_string(horizon_margin));
+    }
+    _horizonMask.setEnabled(horizon_mask);
+    _horizonMask.setMargin(horizon_margin);
+  }
+
   if (v.isObject() && v.isMember("default_camera_state"))
   {
     cs = new Utils::CameraState(nullptr);
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <list>
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
 #include <Filters/Filter.hpp>
+#include <Utils/FrameArena.hpp>
+#include <Utils/FramePool.hpp>
+#include <Utils/HorizonMask.hpp>
+#include <utils/LatencyHistogram.h>
+#include <Utils/WorkerPool.hpp>
 
 #include "rhoban_utils/timing/time_stamp.h"
 
@@ -88,6 +95,51 @@ public:
   /// step
   void step(Filter::UpdateType updateType);
 
+  /// Enable or disable the concurrent processing of the non-root filters
+  /// nb_workers: number of threads used, 0 means one per hardware thread
+  void setParallel(bool parallel, int nb_workers = 0);
+  bool isParallel() const;
+
+  /// Buffers shared by the filters for their output images
+  Utils::FramePool& getFramePool();
+
+  /// Scratch buffers of the filters, reset at the beginning of each step
+  Utils::FrameArena& getFrameArena();
+
+  /// Region of the images below the horizon for the current step, shared by
+  /// all the filters
+  Utils::HorizonMask& getHorizonMask();
+
+  /// Number of buffers allocated/reused by the FramePool during last step
+  int getLastStepAllocations() const;
+  int getLastStepReuses() const;
+
+  /// Number of scratch buffers allocated by the FrameArena during last step
+  int getLastStepScratchAllocations() const;
+
+  /// Return the duration of the last step of each filter [s]
+  /// In parallel mode, filters are processed by worker threads and their
+  /// benchmark does not appear in the tree of the thread calling 'step'
+  std::map<std::string, double> getLastStepTimes() const;
+
+  /// Names of the stages of a step: "sources" (root filters and camera state
+  /// update), "filters" (other filters) and "step" (whole step)
+  std::vector<std::string> getStages() const;
+
+  /// Distribution of the durations of a stage, see getStages
+  const rhoban::LatencyHistogram& getStageLatencies(const std::string& stage) const;
+
+  /// Remove the samples of the stages and of all the filters
+  void resetLatencies();
+
+  /// Publish the latencies of all the filters to RhIO, see
+  /// Filter::publishLatencies
+  void publishLatencies();
+
+  /// Return a table with the percentiles of the durations of each stage and
+  /// of each filter
+  std::string dumpLatencies() const;
+
   /**
    * Call the finish methods on all filters
    */
@@ -108,6 +160,9 @@ public:
   /// 1st format: value is an array of filters
   /// 2nd format: { "filters" : [f1,f2,...], "paths" : [relPath1,relPath2,...]}
   /// In second format, each path contains a list of filters
+  /// The object format also accepts the executor options at top-level:
+  /// "parallel" (bool) and "nbWorkers" (int), and the horizon mask options:
+  /// "horizonMask" (bool) and "horizonMargin" (int)
   void addFiltersFromJson(const Json::Value& v, const std::string& dir_name);
 
   // Json stuff
@@ -150,7 +205,45 @@ private:
   /// Timestamp of the current pipeline execution (usually updated by the source filter)
   rhoban_utils::TimeStamp _timestamp;
 
+  /// Output buffers of the filters
+  Utils::FramePool _framePool;
+
+  /// Scratch buffers of the filters
+  Utils::FrameArena _frameArena;
+
+  /// Rows of the images which can see the ground
+  Utils::HorizonMask _horizonMask;
+
+  /// Durations of the stages of the steps
+  std::map<std::string, rhoban::LatencyHistogram> _stageLatencies;
+
+  /// Statistics of _framePool for the last step
+  int _lastStepAllocations;
+  int _lastStepReuses;
+  int _lastStepScratchAllocations;
+
+  /// When enabled, filters whose dependencies are all solved are processed
+  /// concurrently by '_workers'
+  bool _parallel;
+
+  /// Number of threads in the worker pool, 0 means hardware concurrency
+  int _nbWorkers;
+
+  /// Lazily created when the first parallel step is run
+  std::unique_ptr<Utils::WorkerPool> _workers;
+
   /// Resolve dependencies for all Filters Compute inversed dependency link
   void resolveDependencies();
+
+  /// Process 'ready' filters and all their descendants on the calling thread
+  /// in topological order
+  void runSequential(std::list<Filter*> ready, std::map<std::string, int>* dependenciesSolved);
+
+  /// Process 'ready' filters and all their descendants on the worker pool.
+  /// A filter is scheduled as soon as all its dependencies have been
+  /// processed. Returns when all filters are done, if one of the filters threw
+  /// an exception, no new filter is scheduled and the first exception is
+  /// rethrown
+  void runParallel(std::list<Filter*> ready, std::map<std::string, int>* dependenciesSolved);
 };
 }  // namespace Vision
@@ -1,5 +1,6 @@
 #include "SourceFactory.hpp"
 
+#include "SourceLogContainer.hpp"
 #include "SourceLogs.hpp"
 #include "SourceOpenCV.hpp"
 #include "SourceVideoProtobuf.hpp"
@@ -19,6 +20,7 @@ namespace Filters
 {
 void registerSourceFilters(FilterFactory* ff)
 {
+  ff->registerBuilder("SourceLogContainer", []() { return std::unique_ptr<Filter>(new SourceLogContainer); });
   ff->registerBuilder("SourceLogs", []() { return std::unique_ptr<Filter>(new SourceLogs); });
   ff->registerBuilder("SourceOpenCV", []() { return std::unique_ptr<Filter>(new SourceOpenCV); });
   ff->registerBuilder("SourceVideoProtobuf", []() { return std::unique_ptr<Filter>(new SourceVideoProtobuf); });
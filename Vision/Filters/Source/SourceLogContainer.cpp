@@ -0,0 +1,166 @@
+#include "Filters/Source/SourceLogContainer.hpp"
+
+#include "CameraState/CameraState.hpp"
+#include <FrameSource/Exceptions.hpp>
+
+#include "rhoban_utils/util.h"
+
+#include <stdexcept>
+
+using namespace hl_communication;
+
+namespace Vision
+{
+namespace Filters
+{
+SourceLogContainer::SourceLogContainer()
+  : Source("SourceLogContainer"), startIndex(0), index(0), nextIndex(0), scheduler(nullptr)
+{
+}
+
+Utils::CameraState* SourceLogContainer::buildCameraState()
+{
+  if (index < 0 || index >= getNbFrames())
+  {
+    throw std::runtime_error(DEBUG_INFO + " invalid index: " + std::to_string(index));
+  }
+  const VideoMetaInformation& header = reader->getHeader();
+  if (!header.has_camera_parameters())
+  {
+    throw std::runtime_error(DEBUG_INFO + " camera_parameters were not provided");
+  }
+  if (!header.has_source_id())
+  {
+    throw std::runtime_error(DEBUG_INFO + " source_id was not provided");
+  }
+  std::map<std::string, FrameEntry> frame_entries = reader->getFrameEntries(index);
+  for (const std::string& name : { "camera_from_world", "camera_from_self", "camera_from_head_base" })
+  {
+    if (frame_entries.count(name) == 0)
+    {
+      throw std::runtime_error(DEBUG_INFO + " no entry '" + name + "' for index " + std::to_string(index));
+    }
+  }
+  return new Utils::CameraState(header.camera_parameters(), frame_entries["camera_from_world"],
+                                frame_entries["camera_from_self"].pose(),
+                                frame_entries["camera_from_head_base"].pose(), header.source_id(), scheduler);
+}
+
+void SourceLogContainer::process()
+{
+  updateImg();
+}
+
+void SourceLogContainer::updateImg()
+{
+  if (nextIndex < 0)
+  {
+    throw Utils::StreamEndException(DEBUG_INFO + " start of stream");
+  }
+  if (nextIndex >= getNbFrames())
+  {
+    throw Utils::StreamEndException(DEBUG_INFO + " end of stream");
+  }
+  index = nextIndex;
+  // Raw images share the memory mapping of the reader, no need to copy them
+  img() = reader->getImage(index);
+  nextIndex = index + 1;
+}
+
+void SourceLogContainer::fromJson(const Json::Value& v, const std::string& dir_name)
+{
+  Filter::fromJson(v, dir_name);
+  rhoban_utils::tryRead(v, "path", &path);
+  rhoban_utils::tryRead(v, "startIndex", &startIndex);
+  reader.reset(new Utils::LogContainerReader(path));
+  if (startIndex != 0)
+  {
+    setIndex(startIndex);
+  }
+}
+
+Json::Value SourceLogContainer::toJson() const
+{
+  Json::Value v = Filter::toJson();
+  v["path"] = path;
+  v["startIndex"] = startIndex;
+  return v;
+}
+
+std::string SourceLogContainer::getClassName() const
+{
+  return "SourceLogContainer";
+}
+
+int SourceLogContainer::expectedDependencies() const
+{
+  return 0;
+}
+
+Source::Type SourceLogContainer::getType() const
+{
+  return Type::Custom;
+}
+
+int64_t SourceLogContainer::getClockOffset() const
+{
+  if (reader->getHeader().has_time_offset())
+  {
+    return reader->getHeader().time_offset();
+  }
+  return Source::getClockOffset();
+}
+
+int SourceLogContainer::getIndex() const
+{
+  return index;
+}
+
+int SourceLogContainer::getNbFrames() const
+{
+  return reader->getNbFrames();
+}
+
+void SourceLogContainer::setIndex(int target_index)
+{
+  if (target_index < 0)
+  {
+    throw std::logic_error(DEBUG_INFO + " failed to set index at position " + std::to_string(target_index));
+  }
+  nextIndex = target_index;
+}
+
+void SourceLogContainer::seek(uint64_t timestamp)
+{
+  nextIndex = reader->findFrame(timestamp);
+}
+
+bool SourceLogContainer::isValid() const
+{
+  return reader != nullptr;
+}
+
+void SourceLogContainer::previous()
+{
+  setIndex(index - 1);
+  updateImg();
+}
+
+void SourceLogContainer::update()
+{
+  setIndex(index);
+  updateImg();
+}
+
+void SourceLogContainer::setScheduler(MoveScheduler* new_scheduler)
+{
+  scheduler = new_scheduler;
+}
+
+void SourceLogContainer::extractHistories(const std::string& histories_path) const
+{
+  reader->extractHistories(histories_path);
+}
+
+}  // namespace Filters
+}  // namespace Vision
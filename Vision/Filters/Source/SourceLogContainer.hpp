@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Filters/Source/Source.hpp"
+#include "Utils/LogContainer.hpp"
+
+#include <memory>
+
+class MoveScheduler;
+
+namespace Vision
+{
+namespace Filters
+{
+/**
+ * SourceLogContainer
+ *
+ * Provides the images and camera states stored in a log container written by
+ * ImageLogger (see Utils/LogContainer.hpp)
+ */
+class SourceLogContainer : public Source
+{
+public:
+  SourceLogContainer();
+
+  // JSON stuff
+  void fromJson(const Json::Value& v, const std::string& dir_name) override;
+  Json::Value toJson() const override;
+  std::string getClassName() const override;
+  int expectedDependencies() const override;
+
+  virtual Type getType() const override;
+
+  int getIndex() const;
+  int getNbFrames() const;
+  void setIndex(int index);
+
+  /// Next image read is the first one with a timestamp greater or equal to
+  /// 'timestamp' [us]
+  void seek(uint64_t timestamp);
+
+  bool isValid() const;
+
+  void update() override;
+  void previous() override;
+  void updateImg();
+
+  void setScheduler(MoveScheduler* scheduler);
+
+  /// Write the low-level histories of the log to 'path'
+  /// throws a logic_error if the log does not contain histories
+  void extractHistories(const std::string& path) const;
+
+protected:
+  /**
+   * @Inherit
+   */
+  virtual void process() override;
+
+  int64_t getClockOffset() const override;
+
+  Utils::CameraState* buildCameraState() override;
+
+private:
+  /// Path to the log container
+  std::string path;
+
+  int startIndex;
+
+  /// Index of the current image (0-based)
+  int index;
+
+  /// Index of the frame which will be read by next call to updateImg
+  int nextIndex;
+
+  std::unique_ptr<Utils::LogContainerReader> reader;
+
+  /**
+   * Hack which allows to get access to the movescheduler when building states
+   */
+  MoveScheduler* scheduler;
+};
+}  // namespace Filters
+}  // namespace Vision
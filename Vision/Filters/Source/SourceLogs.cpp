@@ -13,6 +13,7 @@ namespace Filters
 {
 void SourceLogs::openImageSequence()
 {
+  images.setPrefetch(prefetch, prefetchThreads);
   images.loadImages(imagesFile);
   images.setIndex(startIndex);
 }
@@ -25,7 +26,8 @@ void SourceLogs::process()
 
 void SourceLogs::updateImg()
 {
-  img() = images.getImg().clone();
+  // Each image is decoded in a new buffer which is never modified afterwards, no need to clone it
+  img() = images.getImg();
   if (display)
   {
     std::cout << "Displaying image : " << images.getIndex() << std::endl;
@@ -39,6 +41,8 @@ void SourceLogs::fromJson(const Json::Value& v, const std::string& dir_name)
   Filter::fromJson(v, dir_name);
   rhoban_utils::tryRead(v, "startIndex", &startIndex);
   rhoban_utils::tryRead(v, "imagesFile", &imagesFile);
+  rhoban_utils::tryRead(v, "prefetch", &prefetch);
+  rhoban_utils::tryRead(v, "prefetchThreads", &prefetchThreads);
   openImageSequence();
 }
 
@@ -47,6 +51,8 @@ Json::Value SourceLogs::toJson() const
   Json::Value v = Filter::toJson();
   v["startIndex"] = startIndex;
   v["imagesFile"] = imagesFile;
+  v["prefetch"] = prefetch;
+  v["prefetchThreads"] = prefetchThreads;
   return v;
 }
 
@@ -18,7 +18,7 @@ namespace Filters
 class SourceLogs : public Source
 {
 public:
-  SourceLogs() : Source("SourceLogs")
+  SourceLogs() : Source("SourceLogs"), prefetch(0), prefetchThreads(2)
   {
   }
 
@@ -58,6 +58,10 @@ protected:
 private:
   int startIndex;
   std::string imagesFile;
+  /// Number of images decoded in advance by background threads, 0 to disable
+  int prefetch;
+  /// Number of threads used to decode images in advance
+  int prefetchThreads;
 
   Utils::ImageSequence images;
 };
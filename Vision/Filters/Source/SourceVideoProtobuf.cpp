@@ -18,16 +18,20 @@ namespace Vision
 namespace Filters
 {
 SourceVideoProtobuf::SourceVideoProtobuf()
-  : Source("SourceVideoProtobuf"), startIndex(0), index(0), keepOnlyMovingFrames(false)
+  : Source("SourceVideoProtobuf")
+  , startIndex(0)
+  , index(0)
+  , nextIndex(0)
+  , cacheSize(64)
+  , readAhead(8)
+  , seekInterval(32)
+  , keepOnlyMovingFrames(false)
 {
 }
 
 void SourceVideoProtobuf::openVideo()
 {
-  if (!video.open(videoPath))
-  {
-    throw std::runtime_error(DEBUG_INFO + "failed to open video '" + videoPath + "'");
-  }
+  decoder.reset(new Utils::VideoDecoder(videoPath, cacheSize, readAhead, seekInterval));
 }
 
 void SourceVideoProtobuf::loadMetaInformation()
@@ -43,6 +47,16 @@ void SourceVideoProtobuf::loadMetaInformation()
   {
     throw std::runtime_error(DEBUG_INFO + " size mismatch between cameraFromWorld and cameraFromHeadBase");
   }
+  // Building the index of usable frames backward
+  int nb_frames = cameraFromWorldMeta.frames_size();
+  nextUsableFrame.resize(nb_frames + 1);
+  nextUsableFrame[nb_frames] = nb_frames;
+  for (int frame_idx = nb_frames - 1; frame_idx >= 0; frame_idx--)
+  {
+    const FrameEntry& frame_entry = cameraFromWorldMeta.frames(frame_idx);
+    bool usable = !keepOnlyMovingFrames || (frame_entry.has_status() && frame_entry.status() == FrameStatus::MOVING);
+    nextUsableFrame[frame_idx] = usable ? frame_idx : nextUsableFrame[frame_idx + 1];
+  }
 }
 
 void SourceVideoProtobuf::loadMetaInformation(const std::string& path, hl_communication::VideoMetaInformation* out)
@@ -87,24 +101,18 @@ void SourceVideoProtobuf::process()
 
 void SourceVideoProtobuf::updateImg()
 {
-  index = (int)video.get(cv::CAP_PROP_POS_FRAMES);
-  if (index < 0)
+  if (nextIndex < 0)
   {
     throw Utils::StreamEndException(DEBUG_INFO + " start of stream");
   }
-  if (keepOnlyMovingFrames)
+  index = nextIndex;
+  if (index < (int)nextUsableFrame.size())
   {
-    const FrameEntry& frame_entry = cameraFromWorldMeta.frames(index);
-    if (!frame_entry.has_status() || frame_entry.status() != FrameStatus::MOVING)
-    {
-      setIndex(index);
-    }
-  }
-  video.read(img());
-  if (img().empty())
-  {
-    throw Utils::StreamEndException(DEBUG_INFO + " end of stream");
+    index = nextUsableFrame[index];
   }
+  // Decoded frames are shared with the cache of the decoder and never modified, no need to copy them
+  img() = decoder->getFrame(index);
+  nextIndex = index + 1;
 }
 
 void SourceVideoProtobuf::fromJson(const Json::Value& v, const std::string& dir_name)
@@ -116,6 +124,9 @@ void SourceVideoProtobuf::fromJson(const Json::Value& v, const std::string& dir_
   rhoban_utils::tryRead(v, "cameraFromSelfPath", &cameraFromSelfPath);
   rhoban_utils::tryRead(v, "cameraFromHeadBasePath", &cameraFromHeadBasePath);
   rhoban_utils::tryRead(v, "keepOnlyMovingFrames", &keepOnlyMovingFrames);
+  rhoban_utils::tryRead(v, "cacheSize", &cacheSize);
+  rhoban_utils::tryRead(v, "readAhead", &readAhead);
+  rhoban_utils::tryRead(v, "seekInterval", &seekInterval);
   openVideo();
   loadMetaInformation();
 
@@ -135,6 +146,9 @@ Json::Value SourceVideoProtobuf::toJson() const
   v["cameraFromSelfPath"] = cameraFromSelfPath;
   v["cameraFromHeadBasePath"] = cameraFromHeadBasePath;
   v["keepOnlyMovingFrames"] = keepOnlyMovingFrames;
+  v["cacheSize"] = cacheSize;
+  v["readAhead"] = readAhead;
+  v["seekInterval"] = seekInterval;
   return v;
 }
 
@@ -159,30 +173,22 @@ int SourceVideoProtobuf::getIndex() const
 }
 int SourceVideoProtobuf::getNbFrames() const
 {
-  return (int)video.get(cv::CAP_PROP_FRAME_COUNT);
+  return decoder->getNbFrames();
 }
 
 void SourceVideoProtobuf::setIndex(int target_index)
 {
-  int nb_frames = getNbFrames();
-  while (keepOnlyMovingFrames && target_index < nb_frames)
-  {
-    const FrameEntry& frame_entry = cameraFromWorldMeta.frames(target_index);
-    if (frame_entry.has_status() && frame_entry.status() == FrameStatus::MOVING)
-    {
-      break;
-    }
-    target_index++;
-  }
-  if (!video.set(cv::CAP_PROP_POS_FRAMES, target_index))
+  if (target_index < 0)
   {
-    throw std::logic_error(DEBUG_INFO + " failed to set index at position " + std::to_string(index));
+    throw std::logic_error(DEBUG_INFO + " failed to set index at position " + std::to_string(target_index));
   }
+  // Skipped frames are handled when reading
+  nextIndex = target_index;
 }
 
 bool SourceVideoProtobuf::isValid() const
 {
-  return video.isOpened();
+  return decoder != nullptr;
 }
 
 void SourceVideoProtobuf::previous()
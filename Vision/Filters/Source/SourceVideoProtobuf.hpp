@@ -2,10 +2,12 @@
 
 #include "Filters/Source/Source.hpp"
 #include "FrameSource/ImageSequence.hpp"
+#include "FrameSource/VideoDecoder.hpp"
 
 #include <hl_communication/camera.pb.h>
 
-#include <opencv2/videoio.hpp>
+#include <memory>
+#include <vector>
 
 class MoveScheduler;
 
@@ -55,6 +57,7 @@ protected:
   void openVideo();
 
   /// Load the MetaInformation
+  /// Also builds the index of the frames which can be used
   void loadMetaInformation();
   void loadMetaInformation(const std::string& path, hl_communication::VideoMetaInformation* out);
 
@@ -69,7 +72,24 @@ private:
   /// Index of the current image (0-based)
   int index;
 
-  cv::VideoCapture video;
+  /// Index of the frame which will be read by next call to updateImg
+  int nextIndex;
+
+  /// Decodes the frames of the video in background
+  std::unique_ptr<Utils::VideoDecoder> decoder;
+
+  /// Maximal number of decoded frames kept in memory
+  int cacheSize;
+
+  /// Number of frames decoded in advance during forward playback
+  int readAhead;
+
+  /// Distance between the frames used as targets for seeks in the video
+  int seekInterval;
+
+  /// For each frame index, the first frame with an index greater or equal
+  /// which is not skipped, built once when loading the meta information
+  std::vector<int> nextUsableFrame;
 
   /**
    * If enabled, static and shaking frames are skipped
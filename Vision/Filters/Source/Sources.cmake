@@ -1,6 +1,7 @@
 set (SOURCES
   Source.cpp
   SourceFactory.cpp
+  SourceLogContainer.cpp
   SourceLogs.cpp
   SourceOpenCV.cpp
   SourceVideoProtobuf.cpp
@@ -0,0 +1,97 @@
+#include "FrameSource/ImagePrefetcher.hpp"
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Vision
+{
+namespace Utils
+{
+ImagePrefetcher::Slot::Slot() : index(-1), ready(false)
+{
+}
+
+ImagePrefetcher::ImagePrefetcher(const std::vector<std::string>& paths, int ring_size, int nb_threads)
+  : paths(paths), slots(std::max(1, ring_size))
+{
+  workers.reset(new WorkerPool(std::max(1, nb_threads)));
+}
+
+ImagePrefetcher::~ImagePrefetcher()
+{
+  workers.reset();
+}
+
+cv::Mat ImagePrefetcher::get(int index)
+{
+  if (index < 0 || index >= (int)paths.size())
+  {
+    throw std::out_of_range("ImagePrefetcher: invalid index " + std::to_string(index));
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  for (int offset = 0; offset < (int)slots.size() && index + offset < (int)paths.size(); offset++)
+  {
+    schedule(index + offset);
+  }
+  Slot& slot = slots[index % slots.size()];
+  decoded.wait(lock, [&slot, index]() { return slot.index != index || slot.ready; });
+  // Slot can not be reassigned while we are waiting: only 'get' schedules decodings
+  if (!slot.error.empty())
+  {
+    std::string error = slot.error;
+    // Allow a retry on next request
+    slot.index = -1;
+    throw std::runtime_error(error);
+  }
+  return slot.img;
+}
+
+void ImagePrefetcher::schedule(int index)
+{
+  Slot& slot = slots[index % slots.size()];
+  if (slot.index == index)
+  {
+    return;
+  }
+  slot.index = index;
+  slot.ready = false;
+  slot.img.release();
+  slot.error.clear();
+  workers->push([this, index]() { this->decode(index); });
+}
+
+void ImagePrefetcher::decode(int index)
+{
+  cv::Mat img;
+  std::string error;
+  try
+  {
+    img = cv::imread(paths[index]);
+    if (img.data == NULL)
+    {
+      error = "Failed to read: '" + paths[index] + "'";
+    }
+  }
+  catch (const std::exception& exc)
+  {
+    error = "Failed to read: '" + paths[index] + "': " + exc.what();
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    Slot& slot = slots[index % slots.size()];
+    // Slot might have been reassigned to another image after a seek
+    if (slot.index != index || slot.ready)
+    {
+      return;
+    }
+    slot.img = img;
+    slot.error = error;
+    slot.ready = true;
+  }
+  decoded.notify_all();
+}
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Utils/WorkerPool.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Vision
+{
+namespace Utils
+{
+/// Decodes images of a sequence ahead of time on background threads
+///
+/// When the image at index i is requested, the decoding of the images
+/// [i, i+ringSize[ is scheduled (images already decoded or in progress are
+/// kept). Decoded images are stored in a ring of ringSize slots, slot i % ringSize
+/// is dedicated to image i. Moving backward or jumping to another index is
+/// supported: the window simply moves and the missing images are decoded,
+/// blocking only until the requested one is available.
+class ImagePrefetcher
+{
+public:
+  /// paths: path of all the images of the sequence
+  /// ring_size: maximal number of images decoded in advance (including the current one)
+  /// nb_threads: number of decoding threads
+  ImagePrefetcher(const std::vector<std::string>& paths, int ring_size, int nb_threads);
+
+  /// Wait for the decodings in progress
+  ~ImagePrefetcher();
+
+  /// Return the image at given index, blocking until it is decoded.
+  /// Returned image is never modified by the prefetcher.
+  /// throws a runtime_error if the image could not be read
+  cv::Mat get(int index);
+
+private:
+  struct Slot
+  {
+    Slot();
+
+    /// Index of the image in the sequence, -1 if the slot is unused
+    int index;
+    /// Is the decoding finished
+    bool ready;
+    cv::Mat img;
+    /// Non-empty if the decoding failed
+    std::string error;
+  };
+
+  /// Schedule the decoding of image 'index' unless it is already in its slot
+  /// mutex has to be locked by the caller
+  void schedule(int index);
+
+  /// Decode image 'index' and store it in its slot if it was not reassigned meanwhile
+  void decode(int index);
+
+  std::vector<std::string> paths;
+
+  std::vector<Slot> slots;
+
+  /// Protects 'slots'
+  std::mutex mutex;
+
+  /// Signaled when a decoding is finished
+  std::condition_variable decoded;
+
+  /// Declared last: workers are joined before the other members are destroyed
+  std::unique_ptr<WorkerPool> workers;
+};
+
+}  // namespace Utils
+}  // namespace Vision
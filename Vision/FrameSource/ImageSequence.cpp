@@ -16,7 +16,7 @@ namespace Vision
 {
 namespace Utils
 {
-ImageSequence::ImageSequence() : frameNo(-1), nextFrameNo(0), suffix()
+ImageSequence::ImageSequence() : frameNo(-1), nextFrameNo(0), suffix(), prefetchSize(0), prefetchThreads(1)
 {
 }
 
@@ -52,6 +52,15 @@ void ImageSequence::setIndex(int index)
 void ImageSequence::update()
 {
   frameNo = nextFrameNo;
+  if (prefetcher)
+  {
+    // Same bounds check as imgFileName: StreamEndException outside of the sequence
+    imgOriginalName();
+    // Images are decoded on background threads
+    img = prefetcher->get(frameNo);
+    nextFrameNo = frameNo + 1;
+    return;
+  }
   img = imread(imgFileName());
   if (img.data == NULL)
   {
@@ -109,6 +118,30 @@ void ImageSequence::loadImages(const std::string& fileName)
     prefix = "";
   else
     prefix = fileName.substr(0, lastSeparator + 1);
+  updatePrefetcher();
+}
+
+void ImageSequence::setPrefetch(int nb_frames, int nb_threads)
+{
+  prefetchSize = nb_frames;
+  prefetchThreads = nb_threads;
+  updatePrefetcher();
+}
+
+void ImageSequence::updatePrefetcher()
+{
+  prefetcher.reset();
+  if (prefetchSize <= 0 || images.empty())
+  {
+    return;
+  }
+  std::vector<std::string> paths;
+  for (const std::string& image : images)
+  {
+    paths.push_back(prefix + image + suffix);
+  }
+  // Current image is part of the ring
+  prefetcher.reset(new ImagePrefetcher(paths, prefetchSize + 1, prefetchThreads));
 }
 
 void ImageSequence::previousImg()
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "FrameSource/ImagePrefetcher.hpp"
+
 #include <opencv2/core/core.hpp>
 
+#include <memory>
+
 namespace Vision
 {
 namespace Utils
@@ -17,8 +21,16 @@ private:
   std::vector<std::string> images;
   std::vector<unsigned long> timestamps;
 
+  /// Only used when read-ahead is enabled
+  std::unique_ptr<ImagePrefetcher> prefetcher;
+  int prefetchSize;
+  int prefetchThreads;
+
   void update();
 
+  /// Build a new prefetcher if read-ahead is enabled
+  void updatePrefetcher();
+
 public:
   ImageSequence();
   /**
@@ -38,6 +50,10 @@ public:
   /// or something similar
   void loadImages(const std::string& fileName);
 
+  /// Enable read-ahead: the 'nb_frames' images following the current one are
+  /// decoded by 'nb_threads' background threads. 0 frames disables read-ahead
+  void setPrefetch(int nb_frames, int nb_threads);
+
   /* Load previous or next image, throw exception if operation cannot be
    * done (beginning/end of imageSequence)
    */
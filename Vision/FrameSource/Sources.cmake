@@ -1,5 +1,7 @@
 set(SOURCES
+    ImagePrefetcher.cpp
     ImageSequence.cpp
+    VideoDecoder.cpp
 )
 
 if (ENABLE_FIT_OPTIMIZATIONS)
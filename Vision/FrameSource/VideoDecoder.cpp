@@ -0,0 +1,174 @@
+#include "FrameSource/VideoDecoder.hpp"
+
+#include "FrameSource/Exceptions.hpp"
+
+#include "rhoban_utils/util.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace Vision
+{
+namespace Utils
+{
+VideoDecoder::VideoDecoder(const std::string& path, int cache_size, int read_ahead, int seek_interval)
+  : videoPos(0)
+  , readAhead(std::max(0, read_ahead))
+  , seekInterval(std::max(1, seek_interval))
+  , requested(-1)
+  , seekFailure(-1)
+  , stopping(false)
+{
+  if (!video.open(path))
+  {
+    throw std::runtime_error(DEBUG_INFO + "failed to open video '" + path + "'");
+  }
+  nbFrames = (int)video.get(cv::CAP_PROP_FRAME_COUNT);
+  // Frame count is only an estimation for some codecs, end of stream is detected when reading fails
+  endOfStream = std::numeric_limits<int>::max();
+  cacheSize = std::max(cache_size, seekInterval + readAhead + 1);
+  thread = std::thread([this]() { this->decodeLoop(); });
+}
+
+VideoDecoder::~VideoDecoder()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  newRequest.notify_all();
+  thread.join();
+}
+
+int VideoDecoder::getNbFrames() const
+{
+  return nbFrames;
+}
+
+cv::Mat VideoDecoder::getFrame(int index)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (index < 0)
+  {
+    throw StreamEndException(DEBUG_INFO + " start of stream");
+  }
+  requested = index;
+  seekFailure = -1;
+  newRequest.notify_all();
+  decoded.wait(lock, [this, index]() { return isCached(index) || index >= endOfStream || seekFailure == index; });
+  if (index >= endOfStream)
+  {
+    throw StreamEndException(DEBUG_INFO + " end of stream");
+  }
+  if (!isCached(index))
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to seek to frame " + std::to_string(index));
+  }
+  recency.remove(index);
+  recency.push_front(index);
+  return frames.at(index);
+}
+
+bool VideoDecoder::isCached(int index) const
+{
+  return frames.count(index) > 0;
+}
+
+int VideoDecoder::getNextTask() const
+{
+  // After a failed seek to the requested frame, the decoder waits for a new request
+  if (requested < 0 || seekFailure == requested)
+  {
+    return -1;
+  }
+  int last = std::min(requested + readAhead, endOfStream - 1);
+  for (int index = requested; index <= last; index++)
+  {
+    if (frames.count(index) == 0)
+    {
+      return index;
+    }
+  }
+  return -1;
+}
+
+void VideoDecoder::decodeLoop()
+{
+  while (true)
+  {
+    int task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      newRequest.wait(lock, [this]() { return stopping || getNextTask() >= 0; });
+      if (stopping)
+      {
+        return;
+      }
+      task = getNextTask();
+    }
+    decodeUntil(task);
+  }
+}
+
+void VideoDecoder::decodeUntil(int index)
+{
+  // Seek only if the frame can not be reached by decoding forward from the current position
+  if (index < videoPos || index - videoPos > seekInterval)
+  {
+    int anchor = index - index % seekInterval;
+    if (video.set(cv::CAP_PROP_POS_FRAMES, anchor))
+    {
+      videoPos = anchor;
+    }
+    else if (index < videoPos)
+    {
+      // Only this request fails: the stream might still be readable forward
+      std::unique_lock<std::mutex> lock(mutex);
+      seekFailure = index;
+      decoded.notify_all();
+      return;
+    }
+    // Otherwise the frame is reached by decoding forward from the current position
+  }
+  while (videoPos <= index)
+  {
+    // A new buffer for each frame: frames provided by getFrame are never modified
+    cv::Mat frame;
+    video.read(frame);
+    std::unique_lock<std::mutex> lock(mutex);
+    if (frame.empty())
+    {
+      endOfStream = std::min(endOfStream, videoPos);
+      decoded.notify_all();
+      return;
+    }
+    store(videoPos, frame);
+    videoPos++;
+    decoded.notify_all();
+  }
+}
+
+void VideoDecoder::store(int index, const cv::Mat& frame)
+{
+  if (frames.count(index) == 0)
+  {
+    recency.push_front(index);
+  }
+  frames[index] = frame;
+  while (frames.size() > cacheSize)
+  {
+    int oldest = recency.back();
+    recency.pop_back();
+    // The requested frame is never removed before being provided
+    if (oldest == requested)
+    {
+      recency.push_front(oldest);
+      continue;
+    }
+    frames.erase(oldest);
+  }
+}
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Vision
+{
+namespace Utils
+{
+/// Provides random access to the frames of a video
+///
+/// All the accesses to the video are done by a background thread which:
+/// - Decodes the requested frame if it is not in the cache
+/// - Decodes the 'readAhead' frames following the last requested frame
+///
+/// Seeking in a video is slow and not always frame-accurate, therefore the
+/// decoder only seeks to anchor frames (multiples of 'seekInterval') and
+/// decodes forward from there, storing all the decoded frames in a LRU cache.
+/// Stepping backward then requires a seek only once every 'seekInterval'
+/// frames.
+class VideoDecoder
+{
+public:
+  /// cache_size: maximal number of decoded frames stored (at least seek_interval + read_ahead + 1)
+  /// read_ahead: number of frames decoded in advance after the last requested frame
+  /// seek_interval: distance between two anchor frames
+  /// throws a runtime_error if the video can not be opened
+  VideoDecoder(const std::string& path, int cache_size, int read_ahead, int seek_interval);
+
+  /// Stop and join the decoding thread
+  ~VideoDecoder();
+
+  VideoDecoder(const VideoDecoder& other) = delete;
+  VideoDecoder& operator=(const VideoDecoder& other) = delete;
+
+  int getNbFrames() const;
+
+  /// Return the frame at given index, blocking until it is decoded.
+  /// Returned image is never modified by the decoder.
+  /// throws a StreamEndException if the frame does not exist
+  /// throws a runtime_error if seeking to the frame failed
+  cv::Mat getFrame(int index);
+
+private:
+  /// Main loop of the decoding thread
+  void decodeLoop();
+
+  /// Return the next frame to decode, or -1 if there is nothing to do
+  /// mutex has to be locked by the caller
+  int getNextTask() const;
+
+  /// Place the video so that next read provides frame 'index' and decode all
+  /// frames until 'index' (included), called by the decoding thread only
+  void decodeUntil(int index);
+
+  /// Store a decoded frame in the cache, mutex has to be locked by the caller
+  void store(int index, const cv::Mat& frame);
+
+  /// Return true if frame 'index' is in cache, mutex has to be locked by the
+  /// caller
+  bool isCached(int index) const;
+
+  /// Only accessed by the decoding thread after construction
+  cv::VideoCapture video;
+
+  /// Index of the frame which will be provided by the next read of video
+  int videoPos;
+
+  int nbFrames;
+  size_t cacheSize;
+  int readAhead;
+  int seekInterval;
+
+  /// Decoded frames by index
+  std::map<int, cv::Mat> frames;
+
+  /// Indices of the frames in cache, most recently used first
+  std::list<int> recency;
+
+  /// Last frame requested by getFrame, -1 if none
+  int requested;
+
+  /// Frames greater or equal to this index could not be decoded
+  int endOfStream;
+
+  /// Last frame which could not be reached because seeking failed, -1 if none
+  int seekFailure;
+
+  bool stopping;
+
+  /// Protects all the members except 'video' and 'videoPos'
+  std::mutex mutex;
+
+  /// Signaled when a new frame is requested or when the decoder is stopping
+  std::condition_variable newRequest;
+
+  /// Signaled when a frame has been decoded
+  std::condition_variable decoded;
+
+  std::thread thread;
+};
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,287 @@
+#include "Utils/ColorLUT.hpp"
+
+#include <rhoban_utils/util.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace Vision
+{
+namespace Utils
+{
+namespace
+{
+const char lut_magic[8] = { 'R', 'H', 'L', 'U', 'T', '0', '0', '1' };
+
+template <typename T>
+void writeValue(std::ostream& out, T value)
+{
+  out.write((const char*)&value, sizeof(T));
+}
+
+template <typename T>
+T readValue(std::istream& in)
+{
+  T value;
+  in.read((char*)&value, sizeof(T));
+  if (!in.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " unexpected end of file");
+  }
+  return value;
+}
+
+}  // namespace
+
+ColorLUT::ColorLUT(int bits, const std::vector<std::string>& class_names)
+  : bits(bits), shift(8 - bits), class_names(class_names)
+{
+  if (bits < 1 || bits > 8)
+  {
+    throw std::logic_error(DEBUG_INFO + " invalid number of bits: " + std::to_string(bits));
+  }
+  if (class_names.size() > 255)
+  {
+    throw std::logic_error(DEBUG_INFO + " too many classes: " + std::to_string(class_names.size()));
+  }
+  for (const std::string& class_name : class_names)
+  {
+    if (class_name.size() > 255)
+    {
+      throw std::logic_error(DEBUG_INFO + " class name is too long: '" + class_name + "'");
+    }
+  }
+  table.assign((size_t)1 << (3 * bits), 0);
+}
+
+int ColorLUT::getBits() const
+{
+  return bits;
+}
+
+const std::vector<std::string>& ColorLUT::getClassNames() const
+{
+  return class_names;
+}
+
+uint8_t ColorLUT::getLabel(const std::string& class_name) const
+{
+  for (size_t idx = 0; idx < class_names.size(); idx++)
+  {
+    if (class_names[idx] == class_name)
+    {
+      return idx + 1;
+    }
+  }
+  throw std::out_of_range(DEBUG_INFO + " unknown class '" + class_name + "'");
+}
+
+void ColorLUT::setLabel(uint8_t y, uint8_t u, uint8_t v, uint8_t label)
+{
+  table[getCell(y, u, v)] = label;
+}
+
+const uint8_t* ColorLUT::data() const
+{
+  return table.data();
+}
+
+void ColorLUT::addSamples(const cv::Mat& yuv, uint8_t label, const cv::Mat& mask)
+{
+  if (yuv.type() != CV_8UC3)
+  {
+    throw std::logic_error(DEBUG_INFO + " samples should be of type CV_8UC3");
+  }
+  if (label == 0 || label > class_names.size())
+  {
+    throw std::logic_error(DEBUG_INFO + " invalid label: " + std::to_string(label));
+  }
+  if (!mask.empty() && (mask.type() != CV_8UC1 || mask.size() != yuv.size()))
+  {
+    throw std::logic_error(DEBUG_INFO + " mask should be of type CV_8UC1 and have the size of the samples");
+  }
+  if (samples.size() == 0)
+  {
+    samples.assign(class_names.size() * table.size(), 0);
+  }
+  uint32_t* class_samples = samples.data() + (label - 1) * table.size();
+  for (int row = 0; row < yuv.rows; row++)
+  {
+    const uint8_t* pixels = yuv.ptr<uint8_t>(row);
+    const uint8_t* mask_row = mask.empty() ? nullptr : mask.ptr<uint8_t>(row);
+    for (int col = 0; col < yuv.cols; col++)
+    {
+      if (mask_row == nullptr || mask_row[col] != 0)
+      {
+        class_samples[getCell(pixels[3 * col], pixels[3 * col + 1], pixels[3 * col + 2])]++;
+      }
+    }
+  }
+}
+
+void ColorLUT::build(int min_samples)
+{
+  if (samples.size() == 0)
+  {
+    throw std::logic_error(DEBUG_INFO + " no samples available");
+  }
+  for (size_t cell = 0; cell < table.size(); cell++)
+  {
+    uint8_t best_label = 0;
+    uint32_t best_count = 0;
+    for (size_t class_idx = 0; class_idx < class_names.size(); class_idx++)
+    {
+      uint32_t count = samples[class_idx * table.size() + cell];
+      if (count > best_count)
+      {
+        best_label = class_idx + 1;
+        best_count = count;
+      }
+    }
+    table[cell] = (int)best_count >= min_samples ? best_label : 0;
+  }
+}
+
+void ColorLUT::grow(int iterations)
+{
+  int side = 1 << bits;
+  for (int iteration = 0; iteration < iterations; iteration++)
+  {
+    std::vector<uint8_t> grown = table;
+    for (int y = 0; y < side; y++)
+    {
+      for (int u = 0; u < side; u++)
+      {
+        for (int v = 0; v < side; v++)
+        {
+          size_t cell = ((size_t)y << (2 * bits)) | ((size_t)u << bits) | (size_t)v;
+          if (table[cell] != 0)
+          {
+            continue;
+          }
+          // Using the label of the first labelled neighbor
+          const int neighbors[6][3] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 },
+                                        { 0, 1, 0 },  { 0, 0, -1 }, { 0, 0, 1 } };
+          for (const int* offset : neighbors)
+          {
+            int ny = y + offset[0];
+            int nu = u + offset[1];
+            int nv = v + offset[2];
+            if (ny < 0 || nu < 0 || nv < 0 || ny >= side || nu >= side || nv >= side)
+            {
+              continue;
+            }
+            uint8_t label = table[((size_t)ny << (2 * bits)) | ((size_t)nu << bits) | (size_t)nv];
+            if (label != 0)
+            {
+              grown[cell] = label;
+              break;
+            }
+          }
+        }
+      }
+    }
+    table = std::move(grown);
+  }
+}
+
+void ColorLUT::clearSamples()
+{
+  samples.clear();
+}
+
+void ColorLUT::save(const std::string& path) const
+{
+  std::ofstream out(path, std::ios::binary);
+  if (!out.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to open file '" + path + "'");
+  }
+  out.write(lut_magic, sizeof(lut_magic));
+  writeValue<uint8_t>(out, bits);
+  writeValue<uint8_t>(out, class_names.size());
+  for (const std::string& class_name : class_names)
+  {
+    writeValue<uint8_t>(out, class_name.size());
+    out.write(class_name.data(), class_name.size());
+  }
+  // Labels are run-length encoded: classes form large connected regions
+  std::vector<std::pair<uint32_t, uint8_t>> runs;
+  for (uint8_t label : table)
+  {
+    if (runs.size() == 0 || runs.back().second != label)
+    {
+      runs.push_back({ 0, label });
+    }
+    runs.back().first++;
+  }
+  writeValue<uint32_t>(out, runs.size());
+  for (const std::pair<uint32_t, uint8_t>& run : runs)
+  {
+    writeValue<uint32_t>(out, run.first);
+    writeValue<uint8_t>(out, run.second);
+  }
+  if (!out.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to write in '" + path + "'");
+  }
+}
+
+void ColorLUT::load(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to open file '" + path + "'");
+  }
+  try
+  {
+    char magic[sizeof(lut_magic)];
+    in.read(magic, sizeof(magic));
+    if (!in.good() || memcmp(magic, lut_magic, sizeof(lut_magic)) != 0)
+    {
+      throw std::runtime_error(DEBUG_INFO + " not a color lookup table");
+    }
+    int file_bits = readValue<uint8_t>(in);
+    int nb_classes = readValue<uint8_t>(in);
+    if (file_bits < 1 || file_bits > 8)
+    {
+      throw std::runtime_error(DEBUG_INFO + " invalid number of bits");
+    }
+    std::vector<std::string> file_class_names;
+    for (int idx = 0; idx < nb_classes; idx++)
+    {
+      std::string class_name(readValue<uint8_t>(in), ' ');
+      in.read(&class_name[0], class_name.size());
+      file_class_names.push_back(class_name);
+    }
+    ColorLUT result(file_bits, file_class_names);
+    uint32_t nb_runs = readValue<uint32_t>(in);
+    size_t cell = 0;
+    for (uint32_t run = 0; run < nb_runs; run++)
+    {
+      uint32_t length = readValue<uint32_t>(in);
+      uint8_t label = readValue<uint8_t>(in);
+      if (cell + length > result.table.size() || label > nb_classes)
+      {
+        throw std::runtime_error(DEBUG_INFO + " invalid run");
+      }
+      std::fill(result.table.begin() + cell, result.table.begin() + cell + length, label);
+      cell += length;
+    }
+    if (cell != result.table.size())
+    {
+      throw std::runtime_error(DEBUG_INFO + " missing labels");
+    }
+    *this = std::move(result);
+  }
+  catch (const std::runtime_error& exc)
+  {
+    throw std::runtime_error(std::string(exc.what()) + " in '" + path + "'");
+  }
+}
+
+}  // namespace Utils
+}  // namespace Vision
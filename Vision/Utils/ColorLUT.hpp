@@ -0,0 +1,93 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Vision
+{
+namespace Utils
+{
+/// Lookup table associating a color class to each YCrCb color
+///
+/// The YCrCb cube is divided in (2^bits)^3 cells and each cell stores the
+/// label of a class: 0 for unknown colors, i+1 for the i-th class. With 6
+/// bits per channel, the table uses 256kB and classifying a pixel requires a
+/// single access to the table.
+///
+/// Tables are built from labelled samples: the number of samples of each
+/// class is counted in every cell, then each cell receives the class with the
+/// most samples. Cells without enough samples can be filled by growing the
+/// labelled regions.
+///
+/// Tables are stored in binary files containing the number of bits, the names
+/// of the classes and the run-length encoded labels.
+class ColorLUT
+{
+public:
+  /// @param bits Number of bits used for each channel, in [1, 8]
+  ColorLUT(int bits = 6, const std::vector<std::string>& class_names = {});
+
+  int getBits() const;
+
+  const std::vector<std::string>& getClassNames() const;
+
+  /// Return the label of the class with the given name, throws if there is
+  /// no such class
+  uint8_t getLabel(const std::string& class_name) const;
+
+  inline uint8_t getLabel(uint8_t y, uint8_t u, uint8_t v) const
+  {
+    return table[getCell(y, u, v)];
+  }
+
+  void setLabel(uint8_t y, uint8_t u, uint8_t v, uint8_t label);
+
+  /// Raw access to the labels, indexed by getCell
+  const uint8_t* data() const;
+
+  inline size_t getCell(uint8_t y, uint8_t u, uint8_t v) const
+  {
+    return ((size_t)(y >> shift) << (2 * bits)) | ((size_t)(u >> shift) << bits) | (size_t)(v >> shift);
+  }
+
+  /// Count the pixels of an 8 bits YCrCb image as samples of the given class,
+  /// if 'mask' is not empty, only pixels with a non-zero mask are used
+  void addSamples(const cv::Mat& yuv, uint8_t label, const cv::Mat& mask = cv::Mat());
+
+  /// Label every cell with the class having the most samples in it, cells with
+  /// less than 'min_samples' samples are labelled 0. Samples are kept
+  void build(int min_samples = 1);
+
+  /// Extend labelled regions to neighbor cells labelled 0, 'iterations' times
+  void grow(int iterations);
+
+  /// Remove all the samples, labels are kept
+  void clearSamples();
+
+  /// Write the table to a binary file, throws on failure
+  void save(const std::string& path) const;
+
+  /// Read a table written by save, throws on failure
+  void load(const std::string& path);
+
+private:
+  int bits;
+
+  /// Number of bits dropped from each channel
+  int shift;
+
+  std::vector<std::string> class_names;
+
+  /// Label of each cell
+  std::vector<uint8_t> table;
+
+  /// Number of samples for each class in each cell (class major), empty if
+  /// no samples have been added
+  std::vector<uint32_t> samples;
+};
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,54 @@
+#include "Utils/FrameArena.hpp"
+
+namespace Vision
+{
+namespace Utils
+{
+FrameArena::FrameArena() : generation(0), allocations(0)
+{
+}
+
+cv::Mat FrameArena::acquire(const cv::Size& size, int type)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  Slots& entry = slots[std::make_tuple(size.height, size.width, type)];
+  // First request of this kind of buffer since the last reset
+  if (entry.buffers.size() == 0 || entry.generation != generation)
+  {
+    entry.generation = generation;
+    entry.nbUsed = 0;
+  }
+  if (entry.nbUsed == entry.buffers.size())
+  {
+    allocations++;
+    entry.buffers.push_back(cv::Mat(size, type));
+  }
+  return entry.buffers[entry.nbUsed++];
+}
+
+void FrameArena::reset()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  generation++;
+  allocations = 0;
+}
+
+int FrameArena::getAllocations() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return allocations;
+}
+
+size_t FrameArena::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  size_t total = 0;
+  for (const auto& entry : slots)
+  {
+    total += entry.second.buffers.size();
+  }
+  return total;
+}
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace Vision
+{
+namespace Utils
+{
+/// Scratch buffers used by the filters of a pipeline during a single step
+///
+/// Buffers are requested with a size and a type and remain valid until the
+/// next call to reset, which makes all of them available again in constant
+/// time. Buffers are kept across steps, so once the pipeline is warm, steps do
+/// not allocate memory anymore. Contrary to FramePool, the arena does not
+/// check whether buffers are still referenced: scratch buffers must not be
+/// used after the end of the step.
+///
+/// This class is thread-safe.
+class FrameArena
+{
+public:
+  FrameArena();
+
+  /// Return a buffer of the given size and type which has not been handed
+  /// out since the last reset, content of the buffer is undefined
+  cv::Mat acquire(const cv::Size& size, int type);
+
+  /// Make all the buffers available again
+  void reset();
+
+  /// Number of buffers allocated since last call to reset
+  int getAllocations() const;
+
+  /// Number of buffers owned by the arena
+  size_t size() const;
+
+private:
+  /// Buffers sharing the same rows, cols and type
+  struct Slots
+  {
+    std::vector<cv::Mat> buffers;
+    /// Generation of the last acquire, when it differs from the arena
+    /// generation, all buffers are available
+    uint64_t generation;
+    /// Number of buffers handed out during this generation
+    size_t nbUsed;
+  };
+
+  std::map<std::tuple<int, int, int>, Slots> slots;
+
+  /// Incremented at each reset
+  uint64_t generation;
+
+  int allocations;
+
+  mutable std::mutex mutex;
+};
+
+}  // namespace Utils
+}  // namespace Vision
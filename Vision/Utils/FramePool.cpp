@@ -0,0 +1,81 @@
+#include "Utils/FramePool.hpp"
+
+namespace Vision
+{
+namespace Utils
+{
+FramePool::FramePool(size_t maxBuffers) : maxBuffers(maxBuffers), allocations(0), reuses(0)
+{
+}
+
+cv::Mat FramePool::acquire(const cv::Size& size, int type)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const cv::Mat& buffer : buffers)
+  {
+    if (buffer.size() == size && buffer.type() == type && isFree(buffer))
+    {
+      reuses++;
+      return buffer;
+    }
+  }
+  // Making space by removing free buffers which do not match
+  if (buffers.size() >= maxBuffers)
+  {
+    for (size_t idx = 0; idx < buffers.size();)
+    {
+      if (isFree(buffers[idx]))
+      {
+        buffers[idx] = buffers.back();
+        buffers.pop_back();
+      }
+      else
+      {
+        idx++;
+      }
+    }
+  }
+  allocations++;
+  cv::Mat buffer(size, type);
+  // When the pool is full of used buffers, the new buffer is not tracked
+  if (buffers.size() < maxBuffers)
+  {
+    buffers.push_back(buffer);
+  }
+  return buffer;
+}
+
+int FramePool::getAllocations() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return allocations;
+}
+
+int FramePool::getReuses() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return reuses;
+}
+
+void FramePool::resetStats()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  allocations = 0;
+  reuses = 0;
+}
+
+size_t FramePool::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return buffers.size();
+}
+
+bool FramePool::isFree(const cv::Mat& buffer)
+{
+  // Reading refcount is safe: if it is 1, the pool holds the only reference
+  // and nobody else can increment it concurrently
+  return buffer.u != nullptr && buffer.u->refcount == 1;
+}
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace Vision
+{
+namespace Utils
+{
+/// A pool of image buffers shared by all the filters of a pipeline
+///
+/// Buffers are reference-counted cv::Mat: a buffer can be handed out again
+/// once the pool holds the only reference to it, i.e. once the filter which
+/// produced it and every consumer which kept a view on it released it. This
+/// allows filters to read the output of their dependencies without cloning
+/// it, while the producer writes the next frame in a different buffer.
+///
+/// This class is thread-safe.
+class FramePool
+{
+public:
+  /// @param maxBuffers Above this number of buffers, free buffers are
+  /// destroyed instead of being kept for reuse
+  FramePool(size_t maxBuffers = 256);
+
+  /// Return a buffer of the given size and type which is not referenced
+  /// anywhere else, content of the buffer is undefined
+  cv::Mat acquire(const cv::Size& size, int type);
+
+  /// Number of buffers allocated since last call to resetStats
+  int getAllocations() const;
+
+  /// Number of buffers reused since last call to resetStats
+  int getReuses() const;
+
+  void resetStats();
+
+  /// Number of buffers currently owned by the pool (used or free)
+  size_t size() const;
+
+private:
+  /// Is the pool the only owner of the buffer
+  static bool isFree(const cv::Mat& buffer);
+
+  std::vector<cv::Mat> buffers;
+
+  size_t maxBuffers;
+
+  int allocations;
+  int reuses;
+
+  mutable std::mutex mutex;
+};
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,61 @@
+#include "Utils/HorizonMask.hpp"
+
+#include "CameraState/CameraState.hpp"
+
+#include <algorithm>
+
+namespace Vision
+{
+namespace Utils
+{
+HorizonMask::HorizonMask() : enabled(false), margin(20), upToDate(false), topGroundRow(0), cameraRows(1)
+{
+}
+
+void HorizonMask::setEnabled(bool new_enabled)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  enabled = new_enabled;
+}
+
+bool HorizonMask::isEnabled() const
+{
+  return enabled;
+}
+
+void HorizonMask::setMargin(int new_margin)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  margin = new_margin;
+}
+
+int HorizonMask::getMargin() const
+{
+  return margin;
+}
+
+void HorizonMask::invalidate()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  upToDate = false;
+}
+
+int HorizonMask::getStartRow(const CameraState* cs, int img_rows)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (!enabled || cs == nullptr)
+  {
+    return 0;
+  }
+  if (!upToDate)
+  {
+    topGroundRow = cs->getTopGroundRow();
+    cameraRows = cs->getImgSize().height;
+    upToDate = true;
+  }
+  int start_row = (int)((topGroundRow - margin) * img_rows / (double)cameraRows);
+  return std::min(std::max(start_row, 0), img_rows);
+}
+
+}  // namespace Utils
+}  // namespace Vision
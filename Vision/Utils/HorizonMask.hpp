@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mutex>
+
+namespace Vision
+{
+namespace Utils
+{
+class CameraState;
+
+/// Region of the image in which the ground can be visible for the current frame
+///
+/// The horizon is computed from the CameraState at most once per frame, the
+/// first time it is requested, and shared by all the filters of a pipeline.
+/// Filters use it to skip the rows above the horizon, which can not contain
+/// field features. The region is described by its first row, a margin is
+/// added above the horizon to absorb the approximations of the camera model.
+///
+/// This class is thread-safe.
+class HorizonMask
+{
+public:
+  HorizonMask();
+
+  /// When disabled, the whole image is considered as region of interest
+  void setEnabled(bool enabled);
+  bool isEnabled() const;
+
+  /// Number of rows above horizon kept in the region of interest [px] (camera image)
+  void setMargin(int margin);
+  int getMargin() const;
+
+  /// Discard the horizon of the previous frame, has to be called once the
+  /// CameraState has been updated for the new frame
+  void invalidate();
+
+  /// Return the first row of the region of interest for an image with
+  /// 'img_rows' rows covering the field of view of the camera (images can
+  /// have been rescaled). Returns 0 if the mask is disabled or if there is no
+  /// CameraState available
+  int getStartRow(const CameraState* cs, int img_rows);
+
+private:
+  bool enabled;
+  int margin;
+
+  /// Is topGroundRow valid for the current frame
+  bool upToDate;
+
+  /// First row seeing the ground in the camera image
+  int topGroundRow;
+
+  /// Number of rows in the camera image
+  int cameraRows;
+
+  std::mutex mutex;
+};
+
+}  // namespace Utils
+}  // namespace Vision
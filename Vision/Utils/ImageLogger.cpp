@@ -2,19 +2,212 @@
 #include "ImageLogger.h"
 
 #include <hl_communication/utils.h>
+#include <rhoban_utils/logging/logger.h>
 #include <rhoban_utils/util.h>
 
 #include <opencv2/highgui/highgui.hpp>
 
 using namespace hl_communication;
 
+static rhoban_utils::Logger logger("ImageLogger");
+
 namespace Vision
 {
 namespace Utils
 {
 ImageLogger::ImageLogger(const std::string& logger_prefix, bool store_images_, int max_img)
-  : logger_prefix(logger_prefix), store_images(store_images_), max_img(max_img)
+  : logger_prefix(logger_prefix)
+  , store_images(store_images_)
+  , max_img(max_img)
+  , drop_policy(DropPolicy::DropNewest)
+  , pending_entries(0)
+  , dropped_entries(0)
+  , stopping(false)
+  , memory_budget(0)
+  , compression_quality(90)
+  , stored_bytes(0)
+  , use_container(false)
+  , container_quality(90)
+{
+}
+
+ImageLogger::~ImageLogger()
+{
+  stopWriter();
+  // Pending compressions use the members of the logger
+  compressor.reset();
+}
+
+void ImageLogger::setAsync(size_t queue_size, DropPolicy policy)
+{
+  if (isActive())
+  {
+    throw std::logic_error(DEBUG_INFO + " cannot change writing mode during a session");
+  }
+  stopWriter();
+  drop_policy = policy;
+  if (queue_size == 0)
+  {
+    return;
+  }
+  if (memory_budget > 0)
+  {
+    throw std::logic_error(DEBUG_INFO + " asynchronous writing and compressed storage are exclusive");
+  }
+  queue.reset(new SPSCQueue<std::pair<int, Entry>>(queue_size));
+  stopping = false;
+  writer_thread = std::thread([this]() { this->writerLoop(); });
+}
+
+void ImageLogger::setCompressedStorage(size_t memory_budget_, const std::string& extension, int quality)
+{
+  if (isActive())
+  {
+    throw std::logic_error(DEBUG_INFO + " cannot change storage mode during a session");
+  }
+  if (extension != ".jpg" && extension != ".png")
+  {
+    throw std::logic_error(DEBUG_INFO + " unsupported extension '" + extension + "'");
+  }
+  if (memory_budget_ > 0 && queue)
+  {
+    throw std::logic_error(DEBUG_INFO + " asynchronous writing and compressed storage are exclusive");
+  }
+  memory_budget = memory_budget_;
+  compression_extension = extension;
+  compression_quality = quality;
+}
+
+void ImageLogger::setContainerOutput(bool enabled, const std::string& extension, int quality)
+{
+  if (isActive())
+  {
+    throw std::logic_error(DEBUG_INFO + " cannot change output during a session");
+  }
+  use_container = enabled;
+  container_extension = extension;
+  container_quality = quality;
+}
+
+void ImageLogger::compressEntry(int idx, const Entry& entry)
+{
+  bool compressed_stored = false;
+  try
+  {
+    CompressedEntry compressed;
+    compressed.time_stamp = entry.time_stamp;
+    compressed.cs = entry.cs;
+    std::vector<int> params;
+    if (compression_extension == ".jpg")
+    {
+      params = { cv::IMWRITE_JPEG_QUALITY, compression_quality };
+    }
+    else
+    {
+      // Favoring speed over size for lossless compression
+      params = { cv::IMWRITE_PNG_COMPRESSION, 1 };
+    }
+    cv::imencode(compression_extension, entry.img, compressed.data, params);
+    size_t raw_bytes = entry.img.total() * entry.img.elemSize();
+    {
+      std::unique_lock<std::mutex> lock(compression_mutex);
+      stored_bytes += compressed.data.size();
+      stored_bytes -= raw_bytes;
+      compressed_entries[idx] = std::move(compressed);
+      compressed_stored = true;
+    }
+    bytes_released.notify_all();
+    // Making room for the next image, otherwise pushEntry would wait or drop it
+    if (stored_bytes + raw_bytes > memory_budget)
+    {
+      writeCompressedEntries();
+    }
+  }
+  catch (const std::exception& exc)
+  {
+    logger.error("Failed to store image %d: %s", idx, exc.what());
+    if (!compressed_stored)
+    {
+      // The raw image is not stored anymore
+      {
+        std::unique_lock<std::mutex> lock(compression_mutex);
+        stored_bytes -= entry.img.total() * entry.img.elemSize();
+      }
+      bytes_released.notify_all();
+    }
+  }
+}
+
+void ImageLogger::writeCompressedEntries()
+{
+  std::map<int, CompressedEntry> to_write;
+  {
+    std::unique_lock<std::mutex> lock(compression_mutex);
+    to_write.swap(compressed_entries);
+  }
+  for (const auto& pair : to_write)
+  {
+    Entry entry;
+    entry.img = cv::imdecode(pair.second.data, cv::IMREAD_COLOR);
+    entry.time_stamp = pair.second.time_stamp;
+    entry.cs = pair.second.cs;
+    writeEntry(pair.first, entry);
+    {
+      std::unique_lock<std::mutex> lock(compression_mutex);
+      stored_bytes -= pair.second.data.size();
+    }
+    bytes_released.notify_all();
+  }
+}
+
+void ImageLogger::stopWriter()
 {
+  if (!writer_thread.joinable())
+  {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    stopping = true;
+  }
+  entry_pushed.notify_all();
+  writer_thread.join();
+  queue.reset();
+}
+
+void ImageLogger::writerLoop()
+{
+  while (true)
+  {
+    std::pair<int, Entry> entry;
+    if (queue->pop(&entry))
+    {
+      writeEntry(entry.first, entry.second);
+      {
+        std::unique_lock<std::mutex> lock(writer_mutex);
+        pending_entries--;
+      }
+      entry_written.notify_all();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    // Remaining entries are written before stopping
+    if (stopping && queue->size() == 0)
+    {
+      return;
+    }
+    entry_pushed.wait(lock, [this]() { return stopping || queue->size() > 0; });
+  }
+}
+
+void ImageLogger::flush()
+{
+  if (!queue)
+  {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(writer_mutex);
+  entry_written.wait(lock, [this]() { return pending_entries == 0; });
 }
 
 bool ImageLogger::isActive() const
@@ -29,8 +222,9 @@ void ImageLogger::pushEntry(const ImageLogger::Entry& cst_entry)
   {
     initSession(cst_entry.cs);
   }
-  // If too much images have been written, throw a SizeLimitException
-  if (img_index >= max_img)
+  // If too much images have been written, throw a SizeLimitException, the
+  // memory budget replaces this limit for compressed storage
+  if (memory_budget == 0 && img_index >= max_img)
   {
     throw SizeLimitException(DEBUG_INFO + " max images reached");
   }
@@ -40,10 +234,67 @@ void ImageLogger::pushEntry(const ImageLogger::Entry& cst_entry)
   entry.time_stamp = cst_entry.time_stamp;
   entry.cs = cst_entry.cs;
   // Store or write imaged depending on mode
-  if (store_images)
+  if (memory_budget > 0)
+  {
+    if (!compressor)
+    {
+      // A single worker ensures that images are written in order
+      compressor.reset(new WorkerPool(1));
+    }
+    size_t raw_bytes = entry.img.total() * entry.img.elemSize();
+    {
+      // Images bigger than the budget are accepted when nothing else is stored
+      std::unique_lock<std::mutex> lock(compression_mutex);
+      auto has_room = [this, raw_bytes]() { return stored_bytes == 0 || stored_bytes + raw_bytes <= memory_budget; };
+      if (drop_policy == DropPolicy::Block)
+      {
+        bytes_released.wait(lock, has_room);
+      }
+      else if (!has_room())
+      {
+        dropped_entries++;
+        return;
+      }
+      stored_bytes += raw_bytes;
+    }
+    int idx = img_index;
+    compressor->push([this, idx, entry]() { this->compressEntry(idx, entry); });
+  }
+  else if (store_images)
   {
     entries_map[img_index] = entry;
   }
+  else if (queue)
+  {
+    std::pair<int, Entry> queued_entry(img_index, entry);
+    {
+      // Counting before pushing: the writer might process the entry immediately
+      std::unique_lock<std::mutex> lock(writer_mutex);
+      pending_entries++;
+    }
+    bool pushed = queue->push(std::move(queued_entry));
+    while (!pushed && drop_policy == DropPolicy::Block)
+    {
+      std::unique_lock<std::mutex> lock(writer_mutex);
+      entry_written.wait(lock, [this]() { return queue->size() < queue->capacity(); });
+      lock.unlock();
+      pushed = queue->push(std::move(queued_entry));
+    }
+    if (!pushed)
+    {
+      {
+        std::unique_lock<std::mutex> lock(writer_mutex);
+        pending_entries--;
+      }
+      dropped_entries++;
+      return;
+    }
+    {
+      // Writer is either before its check of the queue or waiting: the notification can not be lost
+      std::unique_lock<std::mutex> lock(writer_mutex);
+    }
+    entry_pushed.notify_one();
+  }
   else
   {
     writeEntry(img_index, entry);
@@ -53,6 +304,14 @@ void ImageLogger::pushEntry(const ImageLogger::Entry& cst_entry)
 
 void ImageLogger::endSession()
 {
+  // Entries handed to the writer thread have to be written before closing the video
+  flush();
+  if (compressor)
+  {
+    // Destroying the pool waits for all the pending compressions
+    compressor.reset();
+    writeCompressedEntries();
+  }
   if (entries_map.size() != 0)
   {
     for (const auto& pair : entries_map)
@@ -60,17 +319,31 @@ void ImageLogger::endSession()
       writeEntry(pair.first, pair.second);
     }
   }
-  video_writer.release();
-  // Can only be written in the end because delimited writing of messages is not supported in protobuf 3.0.0
-  for (auto& entry : metadata)
+  if (container)
   {
-    std::string log_path = session_path + "/" + entry.first + ".pb";
-    hl_communication::writeToFile(log_path, entry.second);
+    if (histories_path != "")
+    {
+      container->writeHistories(histories_path);
+    }
+    container->close();
+    container.reset();
+  }
+  else
+  {
+    video_writer.release();
+    // Can only be written in the end because delimited writing of messages is not supported in protobuf 3.0.0
+    for (auto& entry : metadata)
+    {
+      std::string log_path = session_path + "/" + entry.first + ".pb";
+      hl_communication::writeToFile(log_path, entry.second);
+    }
   }
   metadata.clear();
+  histories_path = "";
   session_path = "";
   entries_map.clear();
   img_index = 0;
+  dropped_entries = 0;
 }
 
 void ImageLogger::initSession(const CameraState& cs, const std::string& session_local_path)
@@ -89,21 +362,29 @@ void ImageLogger::initSession(const CameraState& cs, const std::string& session_
   {
     throw std::runtime_error(DEBUG_INFO + "Failed to create dir: '" + session_path + "'");
   }
-  std::string filename = session_path + "/video.avi";
-  double framerate = 30;
-  bool use_color = true;
-  video_writer.open(filename, cv::VideoWriter::fourcc('X', 'V', 'I', 'D'), framerate, cs.getImgSize(), use_color);
-  if (!video_writer.isOpened())
-  {
-    throw std::runtime_error(DEBUG_INFO + "Failed to open video");
-  }
   hl_communication::VideoMetaInformation meta_information;
   cs.exportHeader(&meta_information);
   meta_information.set_time_offset(rhoban_utils::getSteadyClockOffset());
-  for (const std::string& log_name :
-       { "camera_from_world", "camera_from_field", "camera_from_self", "camera_from_head_base" })
+  if (use_container)
   {
-    metadata[log_name] = meta_information;
+    container.reset(new LogContainerWriter(session_path + "/log.rhl", meta_information, container_extension,
+                                           container_quality));
+  }
+  else
+  {
+    std::string filename = session_path + "/video.avi";
+    double framerate = 30;
+    bool use_color = true;
+    video_writer.open(filename, cv::VideoWriter::fourcc('X', 'V', 'I', 'D'), framerate, cs.getImgSize(), use_color);
+    if (!video_writer.isOpened())
+    {
+      throw std::runtime_error(DEBUG_INFO + "Failed to open video");
+    }
+    for (const std::string& log_name :
+         { "camera_from_world", "camera_from_field", "camera_from_self", "camera_from_head_base" })
+    {
+      metadata[log_name] = meta_information;
+    }
   }
   // Writing Metadata file
   Json::Value log_metadata;
@@ -118,25 +399,49 @@ void ImageLogger::initSession(const CameraState& cs, const std::string& session_
   }
 }
 
+void ImageLogger::attachHistories(const std::string& path)
+{
+  if (container)
+  {
+    histories_path = path;
+  }
+}
+
 const std::string& ImageLogger::getSessionPath()
 {
   return session_path;
 }
 
+size_t ImageLogger::getQueueDepth() const
+{
+  if (!queue)
+  {
+    return 0;
+  }
+  return queue->size();
+}
+
+int ImageLogger::getDroppedEntries() const
+{
+  return dropped_entries;
+}
+
+size_t ImageLogger::getStoredBytes() const
+{
+  return stored_bytes;
+}
+
 void ImageLogger::writeEntry(int idx, const Entry& e)
 {
-  // Writing image
-  video_writer.write(e.img);
-  // Adding entry_properties to metadata (cannot write in file before end of session)
-  hl_communication::FrameEntry* entry = metadata["camera_from_world"].add_frames();
-  e.cs.exportToProtobuf(entry);
-  entry = metadata["camera_from_self"].add_frames();
+  std::map<std::string, hl_communication::FrameEntry> frame_entries;
+  e.cs.exportToProtobuf(&frame_entries["camera_from_world"]);
+  hl_communication::FrameEntry* entry = &frame_entries["camera_from_self"];
   e.cs.exportToProtobuf(entry);
   setProtobufFromAffine(e.cs.worldToCamera * e.cs.selfToWorld, entry->mutable_pose());
-  entry = metadata["camera_from_head_base"].add_frames();
+  entry = &frame_entries["camera_from_head_base"];
   e.cs.exportToProtobuf(entry);
   setProtobufFromAffine(e.cs.cameraFromHeadBase, entry->mutable_pose());
-  entry = metadata["camera_from_field"].add_frames();
+  entry = &frame_entries["camera_from_field"];
   e.cs.exportToProtobuf(entry);
   if (e.cs.has_camera_field_transform)
   {
@@ -146,6 +451,18 @@ void ImageLogger::writeEntry(int idx, const Entry& e)
   {
     entry->clear_pose();
   }
+  if (container)
+  {
+    container->writeFrame(e.time_stamp, e.img, frame_entries);
+    return;
+  }
+  // Writing image
+  video_writer.write(e.img);
+  // Adding entry_properties to metadata (cannot write in file before end of session)
+  for (const auto& pair : frame_entries)
+  {
+    *(metadata[pair.first].add_frames()) = pair.second;
+  }
 }
 
 }  // namespace Utils
@@ -1,14 +1,22 @@
 #pragma once
 
 #include <CameraState/CameraState.hpp>
+#include <Utils/LogContainer.hpp>
+#include <Utils/SPSCQueue.hpp>
+#include <Utils/WorkerPool.hpp>
 
 #include <rhoban_utils/timing/time_stamp.h>
 
 #include <opencv2/core/core.hpp>
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 namespace Vision
 {
@@ -26,9 +34,36 @@ namespace Utils
 /// There are two different modes of logging:
 /// 1. Images are stored and logged at the end of the session
 /// 2. Images are written directly
+///
+/// In the second mode, entries can be handed to a dedicated writer thread
+/// through a bounded lock-free queue (see setAsync), so that encoding the
+/// video does not delay the caller of pushEntry.
+///
+/// Images can also be compressed in memory by a worker thread (see
+/// setCompressedStorage). Memory usage is then bounded by a budget in bytes
+/// instead of a number of images: when there is no room left for another
+/// image, the compressed images are written to the session folder by the
+/// worker and removed from memory. Images waiting for compression also count
+/// in the budget, when they exhaust it pushEntry applies the drop policy.
+/// Compressed storage and the writer thread are exclusive: enabling one while
+/// the other is enabled throws.
+///
+/// By default, a session contains a video and protobuf files with the camera
+/// states. Sessions can also be written as a single log container (see
+/// LogContainer.hpp) which can include the low-level histories.
 class ImageLogger
 {
 public:
+  /// Behavior of pushEntry when the queue of the writer thread is full or
+  /// when the memory budget of compressed storage is exhausted
+  enum class DropPolicy
+  {
+    /// The entry is discarded and counted as dropped
+    DropNewest,
+    /// Wait until the writer thread made some room
+    Block
+  };
+
   struct Entry
   {
     /**
@@ -51,6 +86,27 @@ public:
   /// @param max_images The maximal number of images allowed for a single log session
   ImageLogger(const std::string& logger_prefix, bool store_images, int max_images);
 
+  /// Stop the writer thread and the compressor if there are some
+  ~ImageLogger();
+
+  /// Write entries on a dedicated thread using a queue of 'queue_size'
+  /// entries, 0 writes entries synchronously. Only used when images are not
+  /// stored, must not be called during a session nor with compressed storage
+  void setAsync(size_t queue_size, DropPolicy policy);
+
+  /// Store images compressed with the given extension (".jpg" or ".png"),
+  /// quality is used for jpeg only. Stored images, compressed or not, never
+  /// use more than 'memory_budget' bytes, entries exceeding it are handled
+  /// according to the drop policy (see setAsync) and the maximal number of
+  /// images is not used. A budget of 0 disables compression. Must not be
+  /// called during a session nor with a writer thread
+  void setCompressedStorage(size_t memory_budget, const std::string& extension = ".jpg", int quality = 90);
+
+  /// Write sessions as a log container 'log.rhl' instead of a video and
+  /// protobuf files, see LogContainerWriter for extension and quality. Must
+  /// not be called during a session
+  void setContainerOutput(bool enabled, const std::string& extension = ".jpg", int quality = 90);
+
   /// Is the logger currently active?
   bool isActive() const;
 
@@ -66,9 +122,23 @@ public:
   /// Close current session and dump images if necessary
   void endSession();
 
+  /// Include the low-level log at 'path' in the current session when it
+  /// ends, only used when writing log containers
+  void attachHistories(const std::string& path);
+
   /// Return the path to current session (empty if no session is in progress)
   const std::string& getSessionPath();
 
+  /// Number of entries waiting for the writer thread
+  size_t getQueueDepth() const;
+
+  /// Number of entries dropped because the queue was full or the memory
+  /// budget exhausted since the beginning of the session
+  int getDroppedEntries() const;
+
+  /// Number of bytes used by the images stored in compressed storage mode
+  size_t getStoredBytes() const;
+
   class SizeLimitException : public std::runtime_error
   {
   public:
@@ -95,6 +165,69 @@ private:
   std::map<std::string, hl_communication::VideoMetaInformation> metadata;
   cv::VideoWriter video_writer;
 
+  /// Entries waiting for the writer thread with their index
+  std::unique_ptr<SPSCQueue<std::pair<int, Entry>>> queue;
+  DropPolicy drop_policy;
+  std::thread writer_thread;
+  /// Number of entries pushed in the queue and not written yet
+  std::atomic<int> pending_entries;
+  std::atomic<int> dropped_entries;
+  std::atomic<bool> stopping;
+  /// Only used to sleep and wake up the threads, the queue does not require it
+  std::mutex writer_mutex;
+  /// Signaled when an entry is pushed or when the writer is stopping
+  std::condition_variable entry_pushed;
+  /// Signaled when an entry has been written
+  std::condition_variable entry_written;
+
+  /// Main loop of the writer thread
+  void writerLoop();
+
+  /// Wait until all the entries of the queue have been written
+  void flush();
+
+  /// Stop and join the writer thread if there is one
+  void stopWriter();
+
+  /// Are sessions written as log containers?
+  bool use_container;
+  std::string container_extension;
+  int container_quality;
+  /// Output of the current session when using log containers
+  std::unique_ptr<LogContainerWriter> container;
+  /// Low-level log included in the container at the end of the session
+  std::string histories_path;
+
+  /// An image compressed in memory
+  struct CompressedEntry
+  {
+    std::vector<uchar> data;
+    uint64_t time_stamp;
+    CameraState cs;
+  };
+
+  /// Maximal number of bytes used by stored images, 0 if compression is disabled
+  size_t memory_budget;
+  std::string compression_extension;
+  int compression_quality;
+  /// Compresses and writes stored images in order, exists only during sessions
+  std::unique_ptr<WorkerPool> compressor;
+  /// Compressed images which have not been written yet
+  std::map<int, CompressedEntry> compressed_entries;
+  /// Bytes used by the images stored, including the ones not compressed yet
+  std::atomic<size_t> stored_bytes;
+  /// Protects 'compressed_entries' and the updates of 'stored_bytes' waited for
+  std::mutex compression_mutex;
+  /// Signaled when 'stored_bytes' decreases
+  std::condition_variable bytes_released;
+
+  /// Compress the entry and write all the compressed entries if another
+  /// image would not fit in the budget, run by the compressor
+  void compressEntry(int idx, const Entry& entry);
+
+  /// Decode and write all the compressed entries
+  void writeCompressedEntries();
+
   /// Write a line in the csv file associating file names with timestamps and a
   /// png image for the given file
   void writeEntry(int idx, const Entry& e);
@@ -0,0 +1,433 @@
+#include "Utils/LogContainer.hpp"
+
+#include <rhoban_utils/util.h>
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace hl_communication;
+
+namespace Vision
+{
+namespace Utils
+{
+namespace
+{
+const char file_magic[8] = { 'R', 'H', 'L', 'O', 'G', '0', '0', '1' };
+const char trailer_magic[8] = { 'R', 'H', 'L', 'O', 'G', 'I', 'D', 'X' };
+
+bool compareTimestamps(const LogIndexEntry& a, const LogIndexEntry& b)
+{
+  return a.timestamp < b.timestamp;
+}
+
+/// Append the size of 'src' on 32 bits followed by its content
+void appendSized(const std::string& src, std::string* dst)
+{
+  uint32_t size = src.size();
+  dst->append((const char*)&size, sizeof(size));
+  dst->append(src);
+}
+
+/// Read an element written by appendSized at position 'pos' of 'src' and
+/// move 'pos' after the element
+void readSized(const char* src, size_t src_size, size_t* pos, const char** element, uint32_t* element_size)
+{
+  if (*pos + sizeof(uint32_t) > src_size)
+  {
+    throw std::runtime_error(DEBUG_INFO + " truncated element");
+  }
+  memcpy(element_size, src + *pos, sizeof(uint32_t));
+  *pos += sizeof(uint32_t);
+  if (*element_size > src_size - *pos)
+  {
+    throw std::runtime_error(DEBUG_INFO + " truncated element");
+  }
+  *element = src + *pos;
+  *pos += *element_size;
+}
+
+}  // namespace
+
+LogContainerWriter::LogContainerWriter(const std::string& path, const VideoMetaInformation& header,
+                                       const std::string& extension, int quality)
+  : path(path), extension(extension), quality(quality), offset(0), histories_offset(0)
+{
+  if (extension != ".raw" && extension != ".jpg" && extension != ".png")
+  {
+    throw std::logic_error(DEBUG_INFO + " unsupported extension '" + extension + "'");
+  }
+  out.open(path, std::ios::binary);
+  if (!out.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to open file '" + path + "'");
+  }
+  out.write(file_magic, sizeof(file_magic));
+  offset = sizeof(file_magic);
+  VideoMetaInformation header_only(header);
+  header_only.clear_frames();
+  writeChunk(LogChunkType::Header, 0, header_only.SerializeAsString());
+}
+
+LogContainerWriter::~LogContainerWriter()
+{
+  if (out.is_open())
+  {
+    try
+    {
+      close();
+    }
+    catch (const std::runtime_error& exc)
+    {
+      std::cerr << DEBUG_INFO << " failed to close '" << path << "': " << exc.what() << std::endl;
+    }
+  }
+}
+
+void LogContainerWriter::writeFrame(uint64_t timestamp, const cv::Mat& img,
+                                    const std::map<std::string, FrameEntry>& frame_entries)
+{
+  LogImageHeader img_header;
+  img_header.rows = img.rows;
+  img_header.cols = img.cols;
+  img_header.type = img.type();
+  img_header.encoded = extension == ".raw" ? 0 : 1;
+  std::string img_payload((const char*)&img_header, sizeof(img_header));
+  if (extension == ".raw")
+  {
+    size_t row_size = img.cols * img.elemSize();
+    img_payload.reserve(img_payload.size() + img.rows * row_size);
+    for (int row = 0; row < img.rows; row++)
+    {
+      img_payload.append((const char*)img.ptr(row), row_size);
+    }
+  }
+  else
+  {
+    std::vector<int> params;
+    if (extension == ".jpg")
+    {
+      params = { cv::IMWRITE_JPEG_QUALITY, quality };
+    }
+    std::vector<uchar> buffer;
+    cv::imencode(extension, img, buffer, params);
+    img_payload.append((const char*)buffer.data(), buffer.size());
+  }
+  LogIndexEntry entry;
+  entry.timestamp = timestamp;
+  entry.image_offset = writeChunk(LogChunkType::Image, timestamp, img_payload);
+  std::string state_payload;
+  for (const auto& pair : frame_entries)
+  {
+    appendSized(pair.first, &state_payload);
+    appendSized(pair.second.SerializeAsString(), &state_payload);
+  }
+  entry.state_offset = writeChunk(LogChunkType::CameraState, timestamp, state_payload);
+  index.push_back(entry);
+}
+
+void LogContainerWriter::writeHistories(const std::string& histories_path)
+{
+  std::ifstream in(histories_path, std::ios::binary);
+  if (!in.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to open file '" + histories_path + "'");
+  }
+  std::ostringstream content;
+  content << in.rdbuf();
+  histories_offset = writeChunk(LogChunkType::Histories, 0, content.str());
+}
+
+void LogContainerWriter::close()
+{
+  // Frames are usually received in order, but seeking requires a sorted index
+  std::stable_sort(index.begin(), index.end(), compareTimestamps);
+  std::string index_payload((const char*)index.data(), index.size() * sizeof(LogIndexEntry));
+  LogTrailer trailer;
+  trailer.index_offset = writeChunk(LogChunkType::Index, 0, index_payload);
+  trailer.histories_offset = histories_offset;
+  memcpy(trailer.magic, trailer_magic, sizeof(trailer_magic));
+  out.write((const char*)&trailer, sizeof(trailer));
+  bool success = out.good();
+  out.close();
+  if (!success)
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to write trailer in '" + path + "'");
+  }
+}
+
+uint64_t LogContainerWriter::writeChunk(LogChunkType type, uint64_t timestamp, const std::string& payload)
+{
+  LogChunkHeader chunk_header;
+  chunk_header.type = (uint32_t)type;
+  chunk_header.reserved = 0;
+  chunk_header.timestamp = timestamp;
+  chunk_header.size = payload.size();
+  out.write((const char*)&chunk_header, sizeof(chunk_header));
+  out.write(payload.data(), payload.size());
+  if (!out.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to write in '" + path + "'");
+  }
+  uint64_t chunk_offset = offset;
+  offset += sizeof(chunk_header) + payload.size();
+  return chunk_offset;
+}
+
+LogContainerReader::LogContainerReader(const std::string& path)
+  : path(path), fd(-1), data(nullptr), file_size(0), histories_offset(0)
+{
+  fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to open file '" + path + "'");
+  }
+  try
+  {
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0)
+    {
+      throw std::runtime_error(DEBUG_INFO + " failed to stat file '" + path + "'");
+    }
+    file_size = file_stat.st_size;
+    if (file_size < sizeof(file_magic))
+    {
+      throw std::runtime_error(DEBUG_INFO + " file '" + path + "' is too small");
+    }
+    // Private mapping: images shared with the mapping can be modified without altering the file
+    void* mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      throw std::runtime_error(DEBUG_INFO + " failed to map file '" + path + "'");
+    }
+    data = (char*)mapping;
+    if (memcmp(data, file_magic, sizeof(file_magic)) != 0)
+    {
+      throw std::runtime_error(DEBUG_INFO + " '" + path + "' is not a log container");
+    }
+    LogChunkHeader chunk_header = readChunkHeader(sizeof(file_magic), LogChunkType::Header);
+    if (!header.ParseFromArray(getPayload(sizeof(file_magic)), chunk_header.size))
+    {
+      throw std::runtime_error(DEBUG_INFO + " failed to parse header of '" + path + "'");
+    }
+    if (!readIndex())
+    {
+      scanChunks();
+    }
+  }
+  catch (...)
+  {
+    release();
+    throw;
+  }
+}
+
+LogContainerReader::~LogContainerReader()
+{
+  release();
+}
+
+void LogContainerReader::release()
+{
+  if (data != nullptr)
+  {
+    munmap(data, file_size);
+    data = nullptr;
+  }
+  if (fd >= 0)
+  {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+const VideoMetaInformation& LogContainerReader::getHeader() const
+{
+  return header;
+}
+
+size_t LogContainerReader::getNbFrames() const
+{
+  return index.size();
+}
+
+uint64_t LogContainerReader::getTimestamp(size_t idx) const
+{
+  return index.at(idx).timestamp;
+}
+
+size_t LogContainerReader::findFrame(uint64_t timestamp) const
+{
+  LogIndexEntry target;
+  target.timestamp = timestamp;
+  return std::lower_bound(index.begin(), index.end(), target, compareTimestamps) - index.begin();
+}
+
+cv::Mat LogContainerReader::getImage(size_t idx) const
+{
+  uint64_t chunk_offset = index.at(idx).image_offset;
+  LogChunkHeader chunk_header = readChunkHeader(chunk_offset, LogChunkType::Image);
+  if (chunk_header.size < sizeof(LogImageHeader))
+  {
+    throw std::runtime_error(DEBUG_INFO + " invalid image chunk in '" + path + "'");
+  }
+  LogImageHeader img_header;
+  memcpy(&img_header, getPayload(chunk_offset), sizeof(img_header));
+  char* content = data + chunk_offset + sizeof(LogChunkHeader) + sizeof(LogImageHeader);
+  size_t content_size = chunk_header.size - sizeof(LogImageHeader);
+  if (img_header.encoded)
+  {
+    cv::Mat buffer(1, content_size, CV_8UC1, content);
+    return cv::imdecode(buffer, cv::IMREAD_UNCHANGED);
+  }
+  cv::Mat img(img_header.rows, img_header.cols, img_header.type, content);
+  if (img.total() * img.elemSize() != content_size)
+  {
+    throw std::runtime_error(DEBUG_INFO + " invalid image size in '" + path + "'");
+  }
+  return img;
+}
+
+std::map<std::string, FrameEntry> LogContainerReader::getFrameEntries(size_t idx) const
+{
+  uint64_t chunk_offset = index.at(idx).state_offset;
+  LogChunkHeader chunk_header = readChunkHeader(chunk_offset, LogChunkType::CameraState);
+  const char* payload = getPayload(chunk_offset);
+  std::map<std::string, FrameEntry> frame_entries;
+  size_t pos = 0;
+  while (pos < chunk_header.size)
+  {
+    const char* name;
+    const char* entry;
+    uint32_t name_size, entry_size;
+    readSized(payload, chunk_header.size, &pos, &name, &name_size);
+    readSized(payload, chunk_header.size, &pos, &entry, &entry_size);
+    if (!frame_entries[std::string(name, name_size)].ParseFromArray(entry, entry_size))
+    {
+      throw std::runtime_error(DEBUG_INFO + " failed to parse frame entry in '" + path + "'");
+    }
+  }
+  return frame_entries;
+}
+
+bool LogContainerReader::hasHistories() const
+{
+  return histories_offset != 0;
+}
+
+void LogContainerReader::extractHistories(const std::string& dst_path) const
+{
+  if (!hasHistories())
+  {
+    throw std::logic_error(DEBUG_INFO + " no histories in '" + path + "'");
+  }
+  LogChunkHeader chunk_header = readChunkHeader(histories_offset, LogChunkType::Histories);
+  std::ofstream out(dst_path, std::ios::binary);
+  out.write(getPayload(histories_offset), chunk_header.size);
+  if (!out.good())
+  {
+    throw std::runtime_error(DEBUG_INFO + " failed to write file '" + dst_path + "'");
+  }
+}
+
+LogChunkHeader LogContainerReader::readChunkHeader(uint64_t offset, LogChunkType expected_type) const
+{
+  LogChunkHeader chunk_header;
+  if (offset + sizeof(chunk_header) > file_size)
+  {
+    throw std::runtime_error(DEBUG_INFO + " chunk outside of '" + path + "'");
+  }
+  memcpy(&chunk_header, data + offset, sizeof(chunk_header));
+  if (chunk_header.type != (uint32_t)expected_type)
+  {
+    throw std::runtime_error(DEBUG_INFO + " unexpected chunk type " + std::to_string(chunk_header.type) + " in '" +
+                             path + "'");
+  }
+  if (chunk_header.size > file_size - offset - sizeof(chunk_header))
+  {
+    throw std::runtime_error(DEBUG_INFO + " truncated chunk in '" + path + "'");
+  }
+  return chunk_header;
+}
+
+const char* LogContainerReader::getPayload(uint64_t offset) const
+{
+  return data + offset + sizeof(LogChunkHeader);
+}
+
+bool LogContainerReader::readIndex()
+{
+  LogTrailer trailer;
+  if (file_size < sizeof(file_magic) + sizeof(trailer))
+  {
+    return false;
+  }
+  memcpy(&trailer, data + file_size - sizeof(trailer), sizeof(trailer));
+  if (memcmp(trailer.magic, trailer_magic, sizeof(trailer_magic)) != 0)
+  {
+    return false;
+  }
+  LogChunkHeader chunk_header = readChunkHeader(trailer.index_offset, LogChunkType::Index);
+  if (chunk_header.size % sizeof(LogIndexEntry) != 0)
+  {
+    throw std::runtime_error(DEBUG_INFO + " invalid index size in '" + path + "'");
+  }
+  index.resize(chunk_header.size / sizeof(LogIndexEntry));
+  memcpy(index.data(), getPayload(trailer.index_offset), chunk_header.size);
+  histories_offset = trailer.histories_offset;
+  return true;
+}
+
+void LogContainerReader::scanChunks()
+{
+  uint64_t offset = sizeof(file_magic);
+  // Chunk of the image waiting for its camera state, 0 if there is none
+  uint64_t image_offset = 0;
+  LogChunkHeader chunk_header;
+  while (offset + sizeof(chunk_header) <= file_size)
+  {
+    memcpy(&chunk_header, data + offset, sizeof(chunk_header));
+    // The writer was interrupted during this chunk
+    if (chunk_header.size > file_size - offset - sizeof(chunk_header))
+    {
+      break;
+    }
+    switch ((LogChunkType)chunk_header.type)
+    {
+      case LogChunkType::Image:
+        image_offset = offset;
+        break;
+      case LogChunkType::CameraState:
+        if (image_offset != 0)
+        {
+          LogIndexEntry entry;
+          entry.timestamp = chunk_header.timestamp;
+          entry.image_offset = image_offset;
+          entry.state_offset = offset;
+          index.push_back(entry);
+          image_offset = 0;
+        }
+        break;
+      case LogChunkType::Histories:
+        histories_offset = offset;
+        break;
+      default:
+        break;
+    }
+    offset += sizeof(chunk_header) + chunk_header.size;
+  }
+  std::stable_sort(index.begin(), index.end(), compareTimestamps);
+}
+
+}  // namespace Utils
+}  // namespace Vision
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <hl_communication/camera.pb.h>
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Vision
+{
+namespace Utils
+{
+/// A single file containing the images of a log session, the camera state
+/// associated to each image and the low-level histories
+///
+/// The file starts with a magic string, followed by a sequence of chunks.
+/// Each chunk is a LogChunkHeader followed by 'size' bytes of payload:
+/// - Header: VideoMetaInformation without frames (camera parameters, source
+///   id and time offset), always the first chunk
+/// - Image: a LogImageHeader followed by the pixels or the encoded image
+/// - CameraState: the FrameEntry of each transform of the previous image,
+///   stored as [name_size, name, entry_size, entry] with 32 bits sizes
+/// - Histories: content of a low-level log (see ModelService::startLogging)
+/// - Index: one LogIndexEntry per image, sorted by timestamp
+///
+/// The file ends with a LogTrailer pointing to the index chunk. If the file
+/// was not closed properly, readers rebuild the index by scanning the
+/// chunks. Integers are stored with the endianness of the writer.
+enum class LogChunkType : uint32_t
+{
+  Header = 1,
+  Image = 2,
+  CameraState = 3,
+  Histories = 4,
+  Index = 5
+};
+
+struct LogChunkHeader
+{
+  uint32_t type;
+  uint32_t reserved;
+  /// Timestamp of the content [us], 0 if not relevant
+  uint64_t timestamp;
+  /// Size of the payload [bytes]
+  uint64_t size;
+};
+
+struct LogImageHeader
+{
+  int32_t rows;
+  int32_t cols;
+  /// OpenCV type of the image
+  int32_t type;
+  /// 0 if pixels are stored directly, 1 if the image is encoded
+  int32_t encoded;
+};
+
+struct LogIndexEntry
+{
+  uint64_t timestamp;
+  /// Offsets of the chunks in the file
+  uint64_t image_offset;
+  uint64_t state_offset;
+};
+
+struct LogTrailer
+{
+  uint64_t index_offset;
+  /// 0 if there is no histories chunk
+  uint64_t histories_offset;
+  char magic[8];
+};
+
+/// Writes a log container, chunks are appended as entries are received
+class LogContainerWriter
+{
+public:
+  /// Create the file and write the header chunk
+  /// @param extension ".raw" stores the pixels directly, ".jpg" or ".png"
+  ///        store encoded images
+  /// @param quality Quality of jpg images
+  LogContainerWriter(const std::string& path, const hl_communication::VideoMetaInformation& header,
+                     const std::string& extension = ".jpg", int quality = 90);
+
+  /// Close the file if it has not been closed
+  ~LogContainerWriter();
+
+  LogContainerWriter(const LogContainerWriter& other) = delete;
+  LogContainerWriter& operator=(const LogContainerWriter& other) = delete;
+
+  /// Append an image and the frame entries describing the camera state
+  void writeFrame(uint64_t timestamp, const cv::Mat& img,
+                  const std::map<std::string, hl_communication::FrameEntry>& frame_entries);
+
+  /// Append the content of the low-level log at 'path'
+  void writeHistories(const std::string& path);
+
+  /// Write the index and the trailer, then close the file
+  void close();
+
+private:
+  /// Write a chunk and return its offset
+  uint64_t writeChunk(LogChunkType type, uint64_t timestamp, const std::string& payload);
+
+  std::string path;
+  std::ofstream out;
+  std::string extension;
+  int quality;
+  /// Current size of the file
+  uint64_t offset;
+  std::vector<LogIndexEntry> index;
+  /// Offset of the histories chunk, 0 if there is none
+  uint64_t histories_offset;
+};
+
+/// Reads a log container through a memory mapping of the file
+///
+/// Raw images and protobuf messages are read from the mapped memory without
+/// intermediate copies. Seeking by timestamp is a binary search in the index.
+class LogContainerReader
+{
+public:
+  /// Map the file and load its index
+  /// throws a runtime_error if the file is not a valid container
+  LogContainerReader(const std::string& path);
+  ~LogContainerReader();
+
+  LogContainerReader(const LogContainerReader& other) = delete;
+  LogContainerReader& operator=(const LogContainerReader& other) = delete;
+
+  const hl_communication::VideoMetaInformation& getHeader() const;
+
+  size_t getNbFrames() const;
+
+  /// Timestamp of the given frame [us]
+  uint64_t getTimestamp(size_t idx) const;
+
+  /// Return the index of the first frame with a timestamp greater or equal
+  /// to 'timestamp', getNbFrames() if there is none
+  size_t findFrame(uint64_t timestamp) const;
+
+  /// Raw images share the memory of the mapping: they stay valid as long as
+  /// the reader exists and modifying them does not affect the file
+  cv::Mat getImage(size_t idx) const;
+
+  /// Return the frame entries of the given frame, indexed by transform name
+  /// (e.g. "camera_from_world")
+  std::map<std::string, hl_communication::FrameEntry> getFrameEntries(size_t idx) const;
+
+  bool hasHistories() const;
+
+  /// Write the content of the low-level log to 'path', so that it can be
+  /// loaded by ModelService::loadReplay
+  void extractHistories(const std::string& path) const;
+
+private:
+  /// Return the header of the chunk at given offset after checking its type
+  /// and that its payload is inside the file
+  LogChunkHeader readChunkHeader(uint64_t offset, LogChunkType expected_type) const;
+
+  /// Return a pointer to the payload of the chunk at given offset
+  const char* getPayload(uint64_t offset) const;
+
+  /// Read the index chunk designated by the trailer, return false if there is
+  /// no valid trailer
+  bool readIndex();
+
+  /// Build the index by reading all the chunks of the file
+  void scanChunks();
+
+  /// Unmap and close the file
+  void release();
+
+  std::string path;
+  int fd;
+  char* data;
+  size_t file_size;
+  hl_communication::VideoMetaInformation header;
+  std::vector<LogIndexEntry> index;
+  /// Offset of the histories chunk, 0 if there is none
+  uint64_t histories_offset;
+};
+
+}  // namespace Utils
+}  // namespace Vision
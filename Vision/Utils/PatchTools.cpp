@@ -2,6 +2,10 @@
 
 #include "Utils/ROITools.hpp"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace Vision
 {
 namespace Utils
@@ -49,5 +53,78 @@ double getPatchDensity(const cv::Rect& patch, const cv::Mat& integralImage, bool
   return getPatchSum(rect, integralImage, false) / rect.area();
 }
 
+void PatchBatch::clear()
+{
+  x0.clear();
+  y0.clear();
+  x1.clear();
+  y1.clear();
+}
+
+void PatchBatch::reserve(size_t n)
+{
+  x0.reserve(n);
+  y0.reserve(n);
+  x1.reserve(n);
+  y1.reserve(n);
+}
+
+size_t PatchBatch::size() const
+{
+  return x0.size();
+}
+
+void PatchBatch::push(const cv::Rect& patch, const cv::Size& iiSize)
+{
+  cv::Rect rect = iiCropRect(patch, iiSize);
+  x0.push_back(rect.x);
+  y0.push_back(rect.y);
+  x1.push_back(rect.x + rect.width);
+  y1.push_back(rect.y + rect.height);
+}
+
+int PatchBatch::getArea(size_t idx) const
+{
+  return (x1[idx] - x0[idx]) * (y1[idx] - y0[idx]);
+}
+
+void PatchBatch::computeSums(const cv::Mat& integralImage, std::vector<int>* sums) const
+{
+  CV_Assert(integralImage.type() == CV_32SC1);
+  size_t n = size();
+  sums->resize(n);
+  const int* data = integralImage.ptr<int>(0);
+  int stride = (int)(integralImage.step1());
+  size_t idx = 0;
+#ifdef __AVX2__
+  const __m256i vstride = _mm256_set1_epi32(stride);
+  for (; idx + 8 <= n; idx += 8)
+  {
+    __m256i vx0 = _mm256_loadu_si256((const __m256i*)(x0.data() + idx));
+    __m256i vy0 = _mm256_loadu_si256((const __m256i*)(y0.data() + idx));
+    __m256i vx1 = _mm256_loadu_si256((const __m256i*)(x1.data() + idx));
+    __m256i vy1 = _mm256_loadu_si256((const __m256i*)(y1.data() + idx));
+    __m256i row0 = _mm256_mullo_epi32(vy0, vstride);
+    __m256i row1 = _mm256_mullo_epi32(vy1, vstride);
+    __m256i A = _mm256_i32gather_epi32(data, _mm256_add_epi32(row0, vx0), 4);
+    __m256i B = _mm256_i32gather_epi32(data, _mm256_add_epi32(row0, vx1), 4);
+    __m256i C = _mm256_i32gather_epi32(data, _mm256_add_epi32(row1, vx0), 4);
+    __m256i D = _mm256_i32gather_epi32(data, _mm256_add_epi32(row1, vx1), 4);
+    __m256i sum = _mm256_sub_epi32(_mm256_add_epi32(A, D), _mm256_add_epi32(B, C));
+    _mm256_storeu_si256((__m256i*)(sums->data() + idx), sum);
+  }
+#endif
+  for (; idx < n; idx++)
+  {
+    const int* row0 = data + y0[idx] * stride;
+    const int* row1 = data + y1[idx] * stride;
+    int A = row0[x0[idx]];
+    int B = row0[x1[idx]];
+    int C = row1[x0[idx]];
+    int D = row1[x1[idx]];
+    (*sums)[idx] = (A + D) - (B + C);
+  }
+}
+
 }  // namespace Utils
 }  // namespace Vision
@@ -2,6 +2,8 @@
 
 #include <opencv2/core/core.hpp>
 
+#include <vector>
+
 /// A list of common function useful for working on patches on integral images
 
 namespace Vision
@@ -18,5 +20,31 @@ double getPatchSum(const cv::Rect& patch, const cv::Mat& integralImage, bool cro
 /// If patch area is 0, throws a runtime_error
 double getPatchDensity(const cv::Rect& patch, const cv::Mat& integralImage, bool crop = true);
 
+/// Stores the corners of multiple patches as a structure of arrays, this allows
+/// to compute the sums of all the patches on an integral image in a single pass
+/// (using AVX2 gathers when available)
+class PatchBatch
+{
+public:
+  void clear();
+  void reserve(size_t n);
+  size_t size() const;
+
+  /// Add a patch to the batch, the patch is cropped to be inside an integral
+  /// image of size iiSize, similarly to getPatchDensity
+  void push(const cv::Rect& patch, const cv::Size& iiSize);
+
+  /// Return the area of the patch at the given index after cropping
+  int getArea(size_t idx) const;
+
+  /// Compute the sum of each patch over integralImage (CV_32SC1), results are
+  /// identical to getPatchSum
+  void computeSums(const cv::Mat& integralImage, std::vector<int>* sums) const;
+
+private:
+  /// Corners of the patches, (x0,y0) is the top-left, (x1,y1) the bottom-right
+  std::vector<int> x0, y0, x1, y1;
+};
+
 }  // namespace Utils
 }  // namespace Vision
@@ -2,6 +2,8 @@
 
 #include "RotatedRectUtils.hpp"
 
+#include <algorithm>
+
 namespace Vision
 {
 namespace Utils
@@ -120,5 +122,210 @@ double computeOverlapRatio(const cv::Rect& r1, const cv::Rect& r2)
   return ((double)(r1 & r2).area()) / std::min(r1.area(), r2.area());
 }
 
+ROIGridNMS::ROIGridNMS()
+  : cellSize(1), gridCols(0), gridRows(0), maxRois(0), maxOverlapRatio(0), nextOrder(0), visitCounter(0)
+{
+}
+
+ROIGridNMS::ROIGridNMS(const cv::Size& imgSize, int cellSize, int maxRois, double maxOverlapRatio) : ROIGridNMS()
+{
+  reset(imgSize, cellSize, maxRois, maxOverlapRatio);
+}
+
+void ROIGridNMS::clear()
+{
+  for (std::vector<int>& cell : cells)
+  {
+    cell.clear();
+  }
+  entries.clear();
+  freeIds.clear();
+  byScore.clear();
+  nextOrder = 0;
+}
+
+void ROIGridNMS::reset(const cv::Size& imgSize, int cellSize, int maxRois, double maxOverlapRatio)
+{
+  clear();
+  this->maxRois = maxRois;
+  this->maxOverlapRatio = maxOverlapRatio;
+  int newCellSize = std::max(1, cellSize);
+  int newCols = std::max(1, (imgSize.width + newCellSize - 1) / newCellSize);
+  int newRows = std::max(1, (imgSize.height + newCellSize - 1) / newCellSize);
+  if (newCellSize != this->cellSize || newCols != gridCols || newRows != gridRows)
+  {
+    this->cellSize = newCellSize;
+    gridCols = newCols;
+    gridRows = newRows;
+    cells.assign(gridCols * gridRows, std::vector<int>());
+  }
+}
+
+bool ROIGridNMS::insert(double score, const cv::Rect& roi)
+{
+  // Retrieving all the entries in conflict with the candidate
+  visitCounter++;
+  dominated.clear();
+  int x0, x1, y0, y1;
+  getCellRange(roi, &x0, &x1, &y0, &y1);
+  for (int cell_y = y0; cell_y <= y1; cell_y++)
+  {
+    for (int cell_x = x0; cell_x <= x1; cell_x++)
+    {
+      for (int id : cells[cell_y * gridCols + cell_x])
+      {
+        Entry& entry = entries[id];
+        if (entry.lastVisit == visitCounter)
+        {
+          continue;
+        }
+        entry.lastVisit = visitCounter;
+        if (computeOverlapRatio(entry.roi, roi) > maxOverlapRatio)
+        {
+          // Candidate is dominated by an existing entry
+          if (entry.score >= score)
+          {
+            return false;
+          }
+          dominated.push_back(id);
+        }
+      }
+    }
+  }
+
+  if (dominated.size() == 0)
+  {
+    if ((int)size() < maxRois)
+    {
+      addEntry(score, roi, nextOrder++);
+      return true;
+    }
+    // Replace the worst entry if candidate is better
+    if (!byScore.empty() && std::get<0>(*byScore.begin()) < score)
+    {
+      replaceEntry(std::get<2>(*byScore.begin()), score, roi);
+      return true;
+    }
+    return false;
+  }
+  if (dominated.size() == 1)
+  {
+    replaceEntry(dominated[0], score, roi);
+    return true;
+  }
+  for (int id : dominated)
+  {
+    removeEntry(id);
+  }
+  addEntry(score, roi, nextOrder++);
+  return true;
+}
+
+size_t ROIGridNMS::size() const
+{
+  return byScore.size();
+}
+
+std::vector<std::pair<double, cv::Rect>> ROIGridNMS::getROIs() const
+{
+  std::vector<std::pair<uint64_t, int>> ordered;
+  for (size_t id = 0; id < entries.size(); id++)
+  {
+    if (entries[id].alive)
+    {
+      ordered.push_back({ entries[id].order, (int)id });
+    }
+  }
+  std::sort(ordered.begin(), ordered.end());
+  std::vector<std::pair<double, cv::Rect>> result;
+  for (const auto& entry : ordered)
+  {
+    result.push_back({ entries[entry.second].score, entries[entry.second].roi });
+  }
+  return result;
+}
+
+void ROIGridNMS::getCellRange(const cv::Rect& roi, int* x0, int* x1, int* y0, int* y1) const
+{
+  // br() is exclusive
+  *x0 = std::min(std::max(0, roi.x / cellSize), gridCols - 1);
+  *y0 = std::min(std::max(0, roi.y / cellSize), gridRows - 1);
+  *x1 = std::min(std::max(0, (roi.x + roi.width - 1) / cellSize), gridCols - 1);
+  *y1 = std::min(std::max(0, (roi.y + roi.height - 1) / cellSize), gridRows - 1);
+}
+
+int ROIGridNMS::addEntry(double score, const cv::Rect& roi, uint64_t order)
+{
+  int id;
+  if (freeIds.size() > 0)
+  {
+    id = freeIds.back();
+    freeIds.pop_back();
+  }
+  else
+  {
+    id = entries.size();
+    entries.push_back(Entry());
+  }
+  Entry& entry = entries[id];
+  entry.score = score;
+  entry.roi = roi;
+  entry.order = order;
+  entry.lastVisit = visitCounter;
+  entry.alive = true;
+  addToCells(id);
+  byScore.insert(std::make_tuple(score, order, id));
+  return id;
+}
+
+void ROIGridNMS::removeEntry(int id)
+{
+  Entry& entry = entries[id];
+  removeFromCells(id);
+  byScore.erase(std::make_tuple(entry.score, entry.order, id));
+  entry.alive = false;
+  freeIds.push_back(id);
+}
+
+void ROIGridNMS::replaceEntry(int id, double score, const cv::Rect& roi)
+{
+  uint64_t order = entries[id].order;
+  removeEntry(id);
+  // The freed id is at the back of freeIds, therefore it is reused
+  addEntry(score, roi, order);
+}
+
+void ROIGridNMS::addToCells(int id)
+{
+  int x0, x1, y0, y1;
+  getCellRange(entries[id].roi, &x0, &x1, &y0, &y1);
+  for (int cell_y = y0; cell_y <= y1; cell_y++)
+  {
+    for (int cell_x = x0; cell_x <= x1; cell_x++)
+    {
+      cells[cell_y * gridCols + cell_x].push_back(id);
+    }
+  }
+}
+
+void ROIGridNMS::removeFromCells(int id)
+{
+  int x0, x1, y0, y1;
+  getCellRange(entries[id].roi, &x0, &x1, &y0, &y1);
+  for (int cell_y = y0; cell_y <= y1; cell_y++)
+  {
+    for (int cell_x = x0; cell_x <= x1; cell_x++)
+    {
+      std::vector<int>& cell = cells[cell_y * gridCols + cell_x];
+      auto it = std::find(cell.begin(), cell.end(), id);
+      if (it != cell.end())
+      {
+        *it = cell.back();
+        cell.pop_back();
+      }
+    }
+  }
+}
+
 }  // namespace Utils
 }  // namespace Vision
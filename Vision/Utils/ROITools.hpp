@@ -2,6 +2,12 @@
 
 #include <opencv2/core/core.hpp>
 
+#include <cstdint>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 namespace Vision
 {
 namespace Utils
@@ -38,5 +44,95 @@ bool isOverlapping(const cv::Rect& r1, const cv::Rect& r2);
  */
 double computeOverlapRatio(const cv::Rect& r1, const cv::Rect& r2);
 
+/// Non-maximum suppression of scored regions of interest
+///
+/// Rules applied when inserting a candidate:
+/// - If it overlaps (see computeOverlapRatio) a ROI with a higher or equal score, it is ignored
+/// - If it overlaps a single ROI with a lower score, it replaces this ROI
+/// - If it overlaps multiple ROIs with a lower score, they are all removed and the candidate is added
+/// - If it does not overlap any ROI, it is added if there is space left or if it is better than the worst ROI,
+///   in this case, it replaces the worst ROI
+///
+/// ROIs are stored in a uniform grid of cells, therefore only the ROIs sharing a cell with the candidate are
+/// tested for overlap. When the size of the ROIs is close to the size of a cell, insertion is in amortized O(1).
+///
+/// The structure is meant to be reused between frames with reset, which only reallocates the grid when its
+/// dimensions change.
+class ROIGridNMS
+{
+public:
+  /// Empty grid, reset has to be called before inserting candidates
+  ROIGridNMS();
+
+  /// @param imgSize The size of the image containing the ROIs
+  /// @param cellSize The size of the cells of the grid [px]
+  /// @param maxRois The maximal number of ROIs kept
+  /// @param maxOverlapRatio Two ROIs with an overlap ratio above this value are conflicting
+  ROIGridNMS(const cv::Size& imgSize, int cellSize, int maxRois, double maxOverlapRatio);
+
+  /// Remove all the ROIs
+  void clear();
+
+  /// Remove all the ROIs and update the configuration, see constructor for the parameters
+  void reset(const cv::Size& imgSize, int cellSize, int maxRois, double maxOverlapRatio);
+
+  /// Try to insert the candidate according to the rules described above
+  /// Return true if the candidate has been added
+  bool insert(double score, const cv::Rect& roi);
+
+  /// Number of ROIs currently kept
+  size_t size() const;
+
+  /// Return the ROIs with their score, ordered as if they had been stored in a vector where
+  /// replacements are done in place and additions at the end
+  std::vector<std::pair<double, cv::Rect>> getROIs() const;
+
+private:
+  struct Entry
+  {
+    double score;
+    cv::Rect roi;
+    /// Position of the ROI in the ordering of the results
+    uint64_t order;
+    /// Used to avoid testing the same entry twice for a candidate
+    uint64_t lastVisit;
+    bool alive;
+  };
+
+  /// Return the range of cells covered by the roi: [x0,x1]x[y0,y1]
+  void getCellRange(const cv::Rect& roi, int* x0, int* x1, int* y0, int* y1) const;
+
+  /// Add a new entry and return its id
+  int addEntry(double score, const cv::Rect& roi, uint64_t order);
+
+  void removeEntry(int id);
+
+  /// Replace the content of entry 'id' while keeping its position in the ordering
+  void replaceEntry(int id, double score, const cv::Rect& roi);
+
+  void addToCells(int id);
+  void removeFromCells(int id);
+
+  int cellSize;
+  int gridCols;
+  int gridRows;
+  int maxRois;
+  double maxOverlapRatio;
+
+  std::vector<Entry> entries;
+  /// Ids of the entries which are not alive and can be reused
+  std::vector<int> freeIds;
+  /// For each cell, the ids of the entries intersecting it
+  std::vector<std::vector<int>> cells;
+  /// Alive entries sorted by (score, order, id), begin() is the worst ROI
+  std::set<std::tuple<double, uint64_t, int>> byScore;
+
+  uint64_t nextOrder;
+  uint64_t visitCounter;
+
+  /// Buffer reused between insertions
+  std::vector<int> dominated;
+};
+
 }  // namespace Utils
 }  // namespace Vision
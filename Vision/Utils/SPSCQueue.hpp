@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Vision
+{
+namespace Utils
+{
+/// A bounded lock-free queue with a single producer and a single consumer
+///
+/// push must only be called by the producer and pop by the consumer. Several
+/// threads can act as the producer as long as their calls are serialized
+/// (e.g. by a mutex), the same holds for the consumer. Neither push nor pop
+/// ever blocks.
+template <typename T>
+class SPSCQueue
+{
+public:
+  SPSCQueue(size_t capacity) : buffer(capacity + 1), head(0), tail(0)
+  {
+  }
+
+  SPSCQueue(const SPSCQueue& other) = delete;
+  SPSCQueue& operator=(const SPSCQueue& other) = delete;
+
+  /// Add an element at the end of the queue, return false if the queue is full
+  bool push(T&& value)
+  {
+    size_t current_tail = tail.load(std::memory_order_relaxed);
+    size_t next_tail = (current_tail + 1) % buffer.size();
+    if (next_tail == head.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    buffer[current_tail] = std::move(value);
+    tail.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  /// Remove the first element of the queue and store it in 'value', return
+  /// false if the queue is empty
+  bool pop(T* value)
+  {
+    size_t current_head = head.load(std::memory_order_relaxed);
+    if (current_head == tail.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    *value = std::move(buffer[current_head]);
+    // Release resources held by the element as soon as possible
+    buffer[current_head] = T();
+    head.store((current_head + 1) % buffer.size(), std::memory_order_release);
+    return true;
+  }
+
+  /// Number of elements in the queue, only approximate if other threads are
+  /// pushing or popping meanwhile
+  size_t size() const
+  {
+    size_t current_head = head.load(std::memory_order_acquire);
+    size_t current_tail = tail.load(std::memory_order_acquire);
+    return (current_tail + buffer.size() - current_head) % buffer.size();
+  }
+
+  size_t capacity() const
+  {
+    return buffer.size() - 1;
+  }
+
+private:
+  /// One slot is always left empty to distinguish a full queue from an empty one
+  std::vector<T> buffer;
+
+  /// Index of the first element, only written by the consumer
+  std::atomic<size_t> head;
+
+  /// Index of the next free slot, only written by the producer
+  std::atomic<size_t> tail;
+};
+
+}  // namespace Utils
+}  // namespace Vision
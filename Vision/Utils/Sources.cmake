@@ -1,14 +1,20 @@
 set(SOURCES
     BlobUtils.cpp
+    ColorLUT.cpp
     Drawing.cpp
     HomogeneousTransform.cpp
     IDSExceptions.cpp
+    FrameArena.cpp
+    FramePool.cpp
+    HorizonMask.cpp
     ImageLogger.cpp
     Interface.cpp
+    LogContainer.cpp
     OpencvUtils.cpp
     PatchTools.cpp
     ROITools.cpp
     RotatedRectUtils.cpp
     PtGreyExceptions.cpp
+    WorkerPool.cpp
 )
 
@@ -0,0 +1,68 @@
+#include "Utils/WorkerPool.hpp"
+
+#include <algorithm>
+
+namespace Vision
+{
+namespace Utils
+{
+WorkerPool::WorkerPool(size_t nb_workers) : stopping(false)
+{
+  if (nb_workers == 0)
+  {
+    nb_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t idx = 0; idx < nb_workers; idx++)
+  {
+    workers.push_back(std::thread([this]() { this->workerLoop(); }));
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cond.notify_all();
+  for (std::thread& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+void WorkerPool::push(const Task& task)
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    tasks.push_back(task);
+  }
+  cond.notify_one();
+}
+
+size_t WorkerPool::size() const
+{
+  return workers.size();
+}
+
+void WorkerPool::workerLoop()
+{
+  while (true)
+  {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cond.wait(lock, [this]() { return stopping || !tasks.empty(); });
+      if (tasks.empty())
+      {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace Utils
+}  // namespace Vision
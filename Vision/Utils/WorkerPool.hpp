@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vision
+{
+namespace Utils
+{
+/// A fixed set of threads consuming tasks from a FIFO queue
+///
+/// Tasks are run in the order they were pushed, but several tasks can run
+/// concurrently. The pool does not handle exceptions: tasks are expected to
+/// catch everything they throw.
+class WorkerPool
+{
+public:
+  typedef std::function<void()> Task;
+
+  /// Start 'nb_workers' threads, if nb_workers is 0, use the number of
+  /// hardware threads available
+  WorkerPool(size_t nb_workers);
+
+  /// Wait for all the tasks already pushed and join the workers
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool& other) = delete;
+  WorkerPool& operator=(const WorkerPool& other) = delete;
+
+  /// Add a task to the queue, returns immediately
+  void push(const Task& task);
+
+  size_t size() const;
+
+private:
+  /// Main loop of each worker
+  void workerLoop();
+
+  std::vector<std::thread> workers;
+
+  /// Tasks waiting for a worker
+  std::deque<Task> tasks;
+
+  /// Protects 'tasks' and 'stopping'
+  std::mutex mutex;
+
+  /// Signaled when a task is pushed or when the pool is stopping
+  std::condition_variable cond;
+
+  /// When enabled, workers exit as soon as the queue is empty
+  bool stopping;
+};
+
+}  // namespace Utils
+}  // namespace Vision
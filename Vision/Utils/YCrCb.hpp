@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace Vision
+{
+namespace Utils
+{
+/// Row kernels converting 8 bits BGR or RGB pixels to YCrCb
+///
+/// Fixed-point coefficients are the ones used by OpenCV for BGR2YCrCb, thus
+/// results match cv::cvtColor up to rounding. Loops are kept simple so that
+/// they can be vectorized by the compiler.
+namespace YCrCb
+{
+const int shift = 14;
+const int half = 1 << (shift - 1);
+const int delta = 128 << shift;
+const int r2y = 4899;
+const int g2y = 9617;
+const int b2y = 1868;
+const int r2cr = 11682;
+const int b2cb = 9241;
+
+inline uint8_t saturate(int value)
+{
+  return (uint8_t)std::min(255, std::max(0, value));
+}
+
+/// Convert a row of 'cols' interleaved pixels to three planes
+template <int blue_idx, int red_idx>
+inline void convertRow(const uint8_t* src, int cols, uint8_t* y_row, uint8_t* u_row, uint8_t* v_row)
+{
+  for (int x = 0; x < cols; x++)
+  {
+    int b = src[3 * x + blue_idx];
+    int g = src[3 * x + 1];
+    int r = src[3 * x + red_idx];
+    int y = (r * r2y + g * g2y + b * b2y + half) >> shift;
+    y_row[x] = (uint8_t)y;
+    u_row[x] = saturate(((r - y) * r2cr + delta + half) >> shift);
+    v_row[x] = saturate(((b - y) * b2cb + delta + half) >> shift);
+  }
+}
+
+inline void convertBGRRow(const uint8_t* src, int cols, uint8_t* y_row, uint8_t* u_row, uint8_t* v_row)
+{
+  convertRow<0, 2>(src, cols, y_row, u_row, v_row);
+}
+
+inline void convertRGBRow(const uint8_t* src, int cols, uint8_t* y_row, uint8_t* u_row, uint8_t* v_row)
+{
+  convertRow<2, 0>(src, cols, y_row, u_row, v_row);
+}
+
+/// Split a row of 'cols' pixels already in YCrCb
+inline void deinterleaveRow(const uint8_t* src, int cols, uint8_t* y_row, uint8_t* u_row, uint8_t* v_row)
+{
+  for (int x = 0; x < cols; x++)
+  {
+    y_row[x] = src[3 * x];
+    u_row[x] = src[3 * x + 1];
+    v_row[x] = src[3 * x + 2];
+  }
+}
+
+inline void interleaveRow(const uint8_t* y_row, const uint8_t* u_row, const uint8_t* v_row, int cols, uint8_t* dst)
+{
+  for (int x = 0; x < cols; x++)
+  {
+    dst[3 * x] = y_row[x];
+    dst[3 * x + 1] = u_row[x];
+    dst[3 * x + 2] = v_row[x];
+  }
+}
+
+/// Type of a row conversion function
+typedef void (*RowConverter)(const uint8_t* src, int cols, uint8_t* y_row, uint8_t* u_row, uint8_t* v_row);
+
+/// Return the row conversion for 'BGR2YCrCb', 'RGB2YCrCb' or 'none' (source
+/// already in YCrCb), nullptr if the conversion is unknown
+inline RowConverter getRowConverter(const std::string& conversion)
+{
+  if (conversion == "BGR2YCrCb")
+  {
+    return &convertBGRRow;
+  }
+  if (conversion == "RGB2YCrCb")
+  {
+    return &convertRGBRow;
+  }
+  if (conversion == "none")
+  {
+    return &deinterleaveRow;
+  }
+  return nullptr;
+}
+
+}  // namespace YCrCb
+}  // namespace Utils
+}  // namespace Vision